@@ -3,647 +3,751 @@
  * @author Felipe Nepomuceno Coelho (689661)
  */
 
-#include "superFa.cpp"
+#pragma once
 
-/**
- * @brief Checks if two states are equivalent in a set Q
- * 
- * @param s1 The first state
- * @param s2 The second state
- * @param dfa The DFA the states are in
- * @param Q The set of super states
- * @return true if the states are equivalent. false otherwise
- */
-bool areEquivalent(state s1, state s2, FA dfa, std::set<superState> Q) {
-    if (dfa.isFinalState(s1) && !dfa.isFinalState(s2)) {
-        return false;
-    } else if (!dfa.isFinalState(s1) && dfa.isFinalState(s2)) {
-        return false;
-    } else {
-        for (std::string symbol : dfa.getAlphabet()) {
-            state transitionState1 = *dfa.transite(s1,symbol).begin();
-            state transitionState2 = *dfa.transite(s2,symbol).begin();
-            // Checking if the transition states are in the same super state of Q
-            for (superState ss : Q) {
-                if (has(ss,transitionState1) && !has(ss,transitionState2)) {
-                    return false;
-                } else if (!has(ss,transitionState1) && has(ss,transitionState2)) {
-                    return false;
-                } else if (has(ss,transitionState1) && has(ss,transitionState2)) {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
-}
+#include "superFa.cpp"
+#include "subsetTable.cpp"
+#include "lambdaClosure.cpp"
+#include "reParser.cpp"
 
 /**
- * @brief Runs an O(n^2) algorithm that minimizes a DFA.
+ * @brief Minimizes a DFA with Hopcroft's partition refinement algorithm, in O(k n log n) for
+ * n states and k symbols. The DFA is completed with a dead state, which is removed again from
+ * the minimized DFA together with every state equivalent to it.
  * 
  * @param dfa The DFA to be minimized
- * @return The minimized DFA
+ * @param verbose Whether to print the progress of the algorithm and why a FA can not be
+ * minimized. Nothing is printed otherwise
+ * @return The minimized DFA, or the FA unchanged if it can not be minimized
  */
-FA automatonMinimizationAlgorithm(FA dfa) {
+FA automatonMinimizationAlgorithm(FA dfa, bool verbose = true) {
     // Checking if the FA is a DFA
     if (dfa.hasLambda()) {
-        std::cout << "The FA has lambda transitions. Cannot minimize.\n";
+        if (verbose) std::cout << "The FA has lambda transitions. Cannot minimize.\n";
         return dfa;
     }
 
     if (!dfa.isDeterministic()) {
-        std::cout << "The FA is not a DFA. Cannot minimize.\n";
+        if (verbose) std::cout << "The FA is not a DFA. Cannot minimize.\n";
+        return dfa;
+    }
+
+    if (dfa.getInitialStateId() == NO_STATE) {
+        if (verbose) std::cout << "The FA has no initial state. Cannot minimize.\n";
         return dfa;
     }
 
     // Initialization
-    std::cout << "Preparing to run the O(n^2) algorithm...\n";
+    if (verbose) std::cout << "Preparing to run Hopcroft's algorithm...\n";
 
-    std::cout << "Removing unreachable states...\n";
+    if (verbose) std::cout << "Removing unreachable states...\n";
     dfa.removeUnreachableStates();
-    std::cout << "Unreachable states successfully removed.\n";
-
-    std::cout << "Running the O(n^2) algorithm...\n";
-
-    // Algorithm
-    int equivalence = 0;
-    std::set<superState> Q[1024];
-    Q[equivalence] = std::set<superState>();
-    Q[equivalence].insert(dfa.getNonFinalStates());
-    Q[equivalence].insert(dfa.getFinalStates());
-    do {
-        equivalence++;
-        Q[equivalence] = std::set<superState>();
-        Q[equivalence].clear();
-        for(superState ss : Q[equivalence-1]) {
-            // Ignore empty sets
-            if (ss.size() == 0) {
-                continue;
-            }
-            // Sets with 1 element
-            if (ss.size() == 1) {
-                Q[equivalence].insert(ss);
-            }
-            // Sets with 2 elements or more
-            for (int i = 0; i < ss.size()-1; i++) {
-                state compare1 = *std::next(ss.begin(), i);
-                state compare2 = *std::next(ss.begin(), i+1);
-                if (areEquivalent(compare1,compare2,dfa,Q[equivalence-1])) {
-                    // Put in same set
-                    bool had = false; // Indicates if there was already a set with that element
-                    for (superState sss : Q[equivalence]) {
-                        if (has(sss,compare1)) {
-                            superState newSuperState = sss;
-                            Q[equivalence].erase(sss);
-                            newSuperState.insert(compare2);
-                            Q[equivalence].insert(newSuperState);
-                            had = true;
-                            break;
-                        }
-                    }
-                    if (!had) {
-                        superState newSuperState = superState();
-                        newSuperState.insert(compare1);
-                        newSuperState.insert(compare2);
-                        Q[equivalence].insert(newSuperState);
-                    }
-                } else {
-                    // Put in different sets
-                    bool had = false; // Indicates if there was already a set with that element
-                    for (superState sss : Q[equivalence]) {
-                        if (has(sss,compare1)) {
-                            had = true;
-                            break;
-                        }
-                    }
-                    if (had) {
-                        superState newSuperState = superState();
-                        newSuperState.insert(compare2);
-                        Q[equivalence].insert(newSuperState);
-                    } else {
-                        superState newSuperState = superState();
-                        superState newSuperState2 = superState();
-                        newSuperState.insert(compare1);
-                        newSuperState2.insert(compare2);
-                        Q[equivalence].insert(newSuperState);
-                        Q[equivalence].insert(newSuperState2);
-                    }
-                }
-            }
+    if (verbose) std::cout << "Unreachable states successfully removed.\n";
+
+    if (verbose) std::cout << "Running Hopcroft's algorithm...\n";
+
+    // The states of the DFA plus the dead state
+    const stateId dead_state = dfa.getStateCount();
+    const uint32_t state_count = dead_state + 1;
+    const size_t symbol_count = dfa.getSymbolCount();
+
+    // Inverse transitions grouped by target state: inverse[inverse_offsets[t]..inverse_offsets[t+1]]
+    // are the pairs (symbol, from) such that δ(from, symbol) = t
+    std::vector<uint32_t> inverse_offsets(state_count + 1, 0);
+    for (stateId s = 0; s < dead_state; s++) {
+        for (symbolId a = 1; a < symbol_count; a++) {
+            const stateList& targets = dfa.transiteId(s, a);
+            inverse_offsets[(targets.empty() ? dead_state : targets[0]) + 1]++;
         }
-    } while (Q[equivalence].size() != Q[equivalence-1].size());
-    
-
-    // Creating the new FA from a SuperFA
-    SuperFA superDfa = SuperFA();
-
-    // Setting up alphabet (Sigma')
-    for (std::string symbol : dfa.getAlphabet()) {
-        superDfa.addSymbol(symbol);
     }
-
-    // Setting up states (Q')
-    for (superState ss : Q[equivalence]) {
-        superDfa.addState(ss);
+    inverse_offsets[dead_state + 1] += symbol_count - 1;
+    for (uint32_t t = 0; t < state_count; t++) {
+        inverse_offsets[t + 1] += inverse_offsets[t];
+    }
+    std::vector<std::pair<symbolId, stateId>> inverse(inverse_offsets[state_count]);
+    std::vector<uint32_t> inverse_fill(inverse_offsets.begin(), inverse_offsets.end() - 1);
+    for (stateId s = 0; s < dead_state; s++) {
+        for (symbolId a = 1; a < symbol_count; a++) {
+            const stateList& targets = dfa.transiteId(s, a);
+            stateId t = targets.empty() ? dead_state : targets[0];
+            inverse[inverse_fill[t]++] = std::make_pair(a, s);
+        }
     }
-
-    // Setting up initial state (i')
-    for (auto ss : superDfa.getStates()) {
-        if (has(ss,dfa.getInitialState())) {
-            superDfa.setInitialState(ss);
-            break;
+    for (symbolId a = 1; a < symbol_count; a++) {
+        inverse[inverse_fill[dead_state]++] = std::make_pair(a, dead_state);
+    }
+
+    // Partition: the states of block b are elements[block_begin[b]..block_end[b]], and the
+    // first block_marked[b] of them are marked while splitting
+    std::vector<stateId> elements(state_count);
+    std::vector<uint32_t> position(state_count);
+    std::vector<uint32_t> block_of(state_count);
+    std::vector<uint32_t> block_begin;
+    std::vector<uint32_t> block_end;
+    std::vector<uint32_t> block_marked;
+    std::vector<bool> in_worklist;
+    std::vector<uint32_t> worklist;
+
+    // Initial partition (Q0): non-final states first, then final states grouped by the
+    // patterns they accept, so states of different patterns are never merged
+    std::map<std::pair<bool, patternList>, stateList> initial_blocks;
+    for (stateId s = 0; s < state_count; s++) {
+        if (s == dead_state) {
+            initial_blocks[std::make_pair(false, patternList())].push_back(s);
+        } else {
+            initial_blocks[std::make_pair(dfa.isFinalStateId(s), dfa.getAcceptIds(s))].push_back(s);
         }
     }
-
-    // Setting up final states (F')
-    for (auto ss : superDfa.getStates()) {
-        for (state s : dfa.getFinalStates()) {
-            if (has(ss,s)) {
-                superDfa.addFinalState(ss);
-            }
+    uint32_t next_position = 0;
+    uint32_t largest_block = 0;
+    for (auto const& initial_block : initial_blocks) {
+        uint32_t begin = next_position;
+        for (stateId s : initial_block.second) {
+            elements[next_position] = s;
+            position[s] = next_position;
+            block_of[s] = block_begin.size();
+            next_position++;
+        }
+        block_begin.push_back(begin);
+        block_end.push_back(next_position);
+        block_marked.push_back(0);
+        in_worklist.push_back(false);
+        if (next_position - begin > block_end[largest_block] - block_begin[largest_block]) {
+            largest_block = block_begin.size() - 1;
         }
     }
-
-    // Setting up transitions (delta')
-    for (superState X : Q[equivalence]) {
-        for (std::string a : superDfa.getAlphabet()) {
-            for (state e : X) {
-                state transitionState = *dfa.transite(e,a).begin();
-                for (superState Y : Q[equivalence]) {
-                    if (has(Y,transitionState)) {
-                        superDfa.addTransition(X,a,Y);
-                    }
-                }
-            }
+    // All the blocks but the largest one need to be splitters
+    for (uint32_t b = 0; b < block_begin.size(); b++) {
+        if (b != largest_block) {
+            worklist.push_back(b);
+            in_worklist[b] = true;
         }
     }
 
-    std::cout << "O(n^2) algorithm successfully executed.\n";
+    // Refinement
+    std::vector<stateList> predecessors(symbol_count);
+    std::vector<uint32_t> touched_blocks;
+    while (!worklist.empty()) {
+        uint32_t splitter = worklist.back();
+        worklist.pop_back();
+        in_worklist[splitter] = false;
 
-    std::cout << "Minimizing the FA...\n";
+        // Predecessors of the splitter by each symbol
+        for (uint32_t i = block_begin[splitter]; i < block_end[splitter]; i++) {
+            stateId t = elements[i];
+            for (uint32_t j = inverse_offsets[t]; j < inverse_offsets[t + 1]; j++) {
+                predecessors[inverse[j].first].push_back(inverse[j].second);
+            }
+        }
 
-    // Converting the SuperFA to a FA
-    FA newDfa = superDfa.convertToFa();
+        for (symbolId a = 1; a < symbol_count; a++) {
+            if (predecessors[a].empty()) continue;
 
-    std::cout << "FA successfully minimized!\n\n";
+            // Marking the predecessors, moving them to the beginning of their blocks
+            for (stateId s : predecessors[a]) {
+                uint32_t b = block_of[s];
+                uint32_t marked_position = block_begin[b] + block_marked[b];
+                if (block_marked[b] == 0) {
+                    touched_blocks.push_back(b);
+                }
+                stateId swapped = elements[marked_position];
+                elements[position[s]] = swapped;
+                position[swapped] = position[s];
+                elements[marked_position] = s;
+                position[s] = marked_position;
+                block_marked[b]++;
+            }
+            predecessors[a].clear();
+
+            // Splitting the blocks that were partially marked. The new block is always the
+            // smallest part, so it is the one that goes to the worklist
+            for (uint32_t b : touched_blocks) {
+                uint32_t marked = block_marked[b];
+                uint32_t size = block_end[b] - block_begin[b];
+                block_marked[b] = 0;
+                if (marked == size) continue;
+
+                uint32_t new_block = block_begin.size();
+                if (marked <= size - marked) {
+                    block_begin.push_back(block_begin[b]);
+                    block_end.push_back(block_begin[b] + marked);
+                    block_begin[b] += marked;
+                } else {
+                    block_begin.push_back(block_begin[b] + marked);
+                    block_end.push_back(block_end[b]);
+                    block_end[b] = block_begin[b] + marked;
+                }
+                block_marked.push_back(0);
+                for (uint32_t i = block_begin[new_block]; i < block_end[new_block]; i++) {
+                    block_of[elements[i]] = new_block;
+                }
+                in_worklist.push_back(true);
+                worklist.push_back(new_block);
+            }
+            touched_blocks.clear();
+        }
+    }
 
-    return newDfa;
-}
+    if (verbose) std::cout << "Hopcroft's algorithm successfully executed.\n";
 
-/**
- * @brief Concatenates 2 automatons and create a single NFA with the 2 automatons
- * 
- * @param fa1 The starting FA
- * @param fa2 The ending FA
- * @param state_name_differ A pointer to an int that will be used to make the state names differ
- * @return The new NFA
- */
-FA concatAutomatons(FA fa1, FA fa2, int* state_name_differ) {
-    FA newFa = fa1;
-    std::string prefix = std::to_string(*state_name_differ);
-    std::string separator = "c";
+    if (verbose) std::cout << "Minimizing the FA...\n";
 
-    // Adding the alphabet of fa2 to fa1
-    for (std::string symbol : fa2.getAlphabet()) {
-        newFa.addSymbol(symbol);
+    // Creating the new FA. Each block becomes a state named after its sorted states, except
+    // the block of the dead state, that is left out
+    FA newDfa = FA();
+    for (symbolId a = 1; a < symbol_count; a++) {
+        if (dfa.isAlphabetSymbol(a)) {
+            newDfa.addSymbol(dfa.getSymbolName(a));
+        }
     }
 
-    // Adding the states of fa2 to fa1
-    for (state s : fa2.getStates()) {
-        state stateName = prefix + separator + s;
-        newFa.addState(stateName);
-    }
+    uint32_t dead_block = block_of[dead_state];
+    uint32_t initial_block = block_of[dfa.getInitialStateId()];
+    std::vector<stateId> block_state(block_begin.size(), NO_STATE);
+    for (uint32_t b = 0; b < block_begin.size(); b++) {
+        if (b == dead_block && b != initial_block) continue;
 
-    // Adding the transitions of fa2 to fa1
-    for (auto const& xTransition : fa2.getTransitions()) {
-        for (state s : xTransition.second) {
-            state to_state = prefix + separator + s;
-            state from_state = prefix + separator + xTransition.first.first;
-            std::string symbol = xTransition.first.second;
-            newFa.addTransition(from_state,symbol,to_state);
+        std::vector<std::string> names;
+        for (uint32_t i = block_begin[b]; i < block_end[b]; i++) {
+            if (elements[i] != dead_state) {
+                names.push_back(dfa.getStateName(elements[i]));
+            }
         }
-    }
+        std::sort(names.begin(), names.end());
+        std::string state_name = "";
+        for (std::string name : names) {
+            state_name += (name + ",");
+        }
+        state_name.pop_back();
 
-    // Connecting fa1 final states to fa2 initial state
-    for (state s : fa1.getFinalStates()) {
-        state stateName = prefix + separator + fa2.getInitialState();
-        newFa.addTransition(s,"&",stateName);
+        block_state[b] = newDfa.internState(state_name);
+        if (b != dead_block && dfa.isFinalStateId(elements[block_begin[b]])) {
+            newDfa.setFinalStateId(block_state[b]);
+            for (patternId pattern : dfa.getAcceptIds(elements[block_begin[b]])) {
+                newDfa.addAcceptId(block_state[b], pattern);
+            }
+        }
     }
+    newDfa.setInitialStateId(block_state[initial_block]);
 
-    // Removing fa1 final states
-    newFa.clearFinalStates();
-
-    // Adding fa2 final states
-    for (state s : fa2.getFinalStates()) {
-        state stateName = prefix + separator + s;
-        newFa.addFinalState(stateName);
+    for (uint32_t b = 0; b < block_begin.size(); b++) {
+        if (block_state[b] == NO_STATE || b == dead_block) continue;
+        stateId representative = elements[block_begin[b]];
+        for (symbolId a = 1; a < symbol_count; a++) {
+            const stateList& targets = dfa.transiteId(representative, a);
+            if (targets.empty() || block_of[targets[0]] == dead_block) continue;
+            newDfa.addTransitionId(block_state[b], newDfa.internSymbol(dfa.getSymbolName(a)), block_state[block_of[targets[0]]]);
+        }
     }
 
-    return newFa;
+    if (verbose) std::cout << "FA successfully minimized!\n\n";
+
+    return newDfa;
 }
 
+/**
+ * @brief A piece of a NFA under construction, with a single entry state and a single exit state.
+ * All the fragments of a RE are built in the same FA, so combining them only adds a few states
+ * and lambda transitions, instead of copying whole automatons
+ */
+struct nfaFragment {
+    stateId start;
+    stateId end;
+};
 
 /**
- * @brief Creates a Kleene star of a FA
+ * @brief Creates a fragment that reads a single symbol
  * 
- * @param fa The FA to be transformed
- * @param state_name_differ A pointer to an int that will be used to make the state names differ
- * @return The transformed FA
+ * @param automaton The FA where the fragment is built
+ * @param c The symbol. λ if it is &
+ * @return The fragment
  */
-FA kleeneStar(FA fa, int* state_name_differ) {
-    FA newFa = fa;
-    std::string prefix = std::to_string(*state_name_differ);
-    std::string initial_separator = "i";
-    std::string final_separator = "f";
-
-    // Connecting final states to initial state
-    for (state s : fa.getFinalStates()) {
-        newFa.addTransition(s,"&",fa.getInitialState());
-    }
-
-    // Creating new initial state
-    state newInitialState = prefix + initial_separator + fa.getInitialState();
-    newFa.addState(newInitialState);
-    newFa.setInitialState(newInitialState);
-
-    // Connecting new initial state to old initial state
-    newFa.addTransition(newInitialState,"&",fa.getInitialState());
-
-    // Creating new final state
-    state newFinalState = prefix + final_separator + *fa.getFinalStates().begin();
-    newFa.addState(newFinalState);
-
-    // Connecting old final states to new final state
-    for (state s : fa.getFinalStates()) {
-        newFa.addTransition(s,"&",newFinalState);
-    }
-    newFa.clearFinalStates();
-    newFa.addFinalState(newFinalState);
-
-    // Connecting new initial state to new final state
-    newFa.addTransition(newInitialState,"&",newFinalState);
-
-    return newFa;
+nfaFragment singleCharFragment(FA* automaton, std::string c) {
+    nfaFragment fragment = {automaton->newState(), automaton->newState()};
+    automaton->addSymbol(c);
+    automaton->addTransitionId(fragment.start, automaton->internSymbol(c), fragment.end);
+    return fragment;
 }
 
-
 /**
- * @brief Creates a union of 2 automatons (U or + or |)
+ * @brief Creates a fragment that only accepts λ
  * 
- * @param fa1 The first FA
- * @param fa2 The second FA
- * @param state_name_differ A pointer to an int that will be used to make the state names differ
- * @return The new FA
+ * @param automaton The FA where the fragment is built
+ * @return The fragment
  */
-FA uniteAutomatons(FA fa1, FA fa2, int* state_name_differ) {
-    FA newFa = FA();
-    std::string prefix = std::to_string(*state_name_differ);
-    std::string separator1 = "u";
-    std::string separator2 = "s";
-
-    // Adding the alphabet of fa1 and fa2 to the new FA
-    for (std::string symbol : fa1.getAlphabet()) {
-        newFa.addSymbol(symbol);
-    }
-    for (std::string symbol : fa2.getAlphabet()) {
-        newFa.addSymbol(symbol);
-    }
-
-    // Adding the states of fa1 and fa2 to the new FA
-    for (state s : fa1.getStates()) {
-        state stateName = prefix + separator1 + s;
-        newFa.addState(stateName);
-    }
-    for (state s : fa2.getStates()) {
-        state stateName = prefix + separator2 + s;
-        newFa.addState(stateName);
-    }
-
-    // Adding the transitions of fa1 and fa2 to the new FA
-    for (auto const& xTransition : fa1.getTransitions()) {
-        for (state s : xTransition.second) {
-            state to_state = prefix + separator1 + s;
-            state from_state = prefix + separator1 + xTransition.first.first;
-            std::string symbol = xTransition.first.second;
-            newFa.addTransition(from_state,symbol,to_state);
-        }
-    }
-    for (auto const& xTransition : fa2.getTransitions()) {
-        for (state s : xTransition.second) {
-            state to_state = prefix + separator2 + s;
-            state from_state = prefix + separator2 + xTransition.first.first;
-            std::string symbol = xTransition.first.second;
-            newFa.addTransition(from_state,symbol,to_state);
-        }
-    }
-
-    // Creating new initial state
-    state newInitialState = prefix + separator2 + fa1.getInitialState();
-    newFa.addState(newInitialState);
-    newFa.setInitialState(newInitialState);
-
-    // Connecting new initial state to old initial states
-    newFa.addTransition(newInitialState,"&",prefix + separator1 + fa1.getInitialState());
-    newFa.addTransition(newInitialState,"&",prefix + separator2 + fa2.getInitialState());
-
-    // Adding new final state
-    state newFinalState = prefix + separator2 + *fa1.getFinalStates().begin();
-    newFa.addState(newFinalState);
-    newFa.addFinalState(newFinalState);
+nfaFragment emptyFragment(FA* automaton) {
+    stateId s = automaton->newState();
+    return {s, s};
+}
 
-    // Connecting old final states to new final state
-    for (state s : fa1.getFinalStates()) {
-        newFa.addTransition(prefix + separator1 + s,"&",newFinalState);
-    }
-    for (state s : fa2.getFinalStates()) {
-        newFa.addTransition(prefix + separator2 + s,"&",newFinalState);
-    }
+/**
+ * @brief Concatenates 2 fragments
+ * 
+ * @param automaton The FA where the fragments are built
+ * @param fragment1 The starting fragment
+ * @param fragment2 The ending fragment
+ * @return The new fragment
+ */
+nfaFragment concatFragments(FA* automaton, nfaFragment fragment1, nfaFragment fragment2) {
+    automaton->addTransitionId(fragment1.end, LAMBDA, fragment2.start);
+    return {fragment1.start, fragment2.end};
+}
 
-    return newFa;
+/**
+ * @brief Creates a union of 2 fragments (U or + or |)
+ * 
+ * @param automaton The FA where the fragments are built
+ * @param fragment1 The first fragment
+ * @param fragment2 The second fragment
+ * @return The new fragment
+ */
+nfaFragment uniteFragments(FA* automaton, nfaFragment fragment1, nfaFragment fragment2) {
+    nfaFragment fragment = {automaton->newState(), automaton->newState()};
+    automaton->addTransitionId(fragment.start, LAMBDA, fragment1.start);
+    automaton->addTransitionId(fragment.start, LAMBDA, fragment2.start);
+    automaton->addTransitionId(fragment1.end, LAMBDA, fragment.end);
+    automaton->addTransitionId(fragment2.end, LAMBDA, fragment.end);
+    return fragment;
 }
 
 /**
- * @brief Creates a single character FA
+ * @brief Creates a Kleene star of a fragment
  * 
- * @param c The character
- * @param state_name_differ A pointer to an int that will be used to make the state names differ
- * @return The FA
+ * @param automaton The FA where the fragment is built
+ * @param fragment The fragment
+ * @return The new fragment
  */
-FA singleCharAutomaton(std::string c, int* state_name_differ) {
-    FA fa = FA();
-    std::string prefix = std::to_string(*state_name_differ);
-    std::string separator = "a";
-    std::string initial_state_name = prefix + separator + "0";
-    std::string final_state_name = prefix + separator + "1";
-    fa.addState(initial_state_name);
-    fa.addState(final_state_name);
-    fa.setInitialState(initial_state_name);
-    fa.addFinalState(final_state_name);
-    fa.addSymbol(c);
-    fa.addTransition(initial_state_name,c, final_state_name);
-    return fa;
+nfaFragment kleeneStarFragment(FA* automaton, nfaFragment fragment) {
+    nfaFragment star = {automaton->newState(), automaton->newState()};
+    automaton->addTransitionId(star.start, LAMBDA, fragment.start);
+    automaton->addTransitionId(fragment.end, LAMBDA, fragment.start);
+    automaton->addTransitionId(fragment.end, LAMBDA, star.end);
+    automaton->addTransitionId(star.start, LAMBDA, star.end);
+    return star;
 }
 
 /**
- * @brief Turns a sub-expression of a RE into a FA
+ * @brief Builds the fragment of a RE in postfix form, keeping the fragments of the operands
+ * not consumed yet in a stack
  * 
- * @param re The complete RE
- * @param reading_index The index of the RE where the sub-expression starts
- * @param state_name_differ A pointer to an integer that will be used to make the names of the states of the FA unique
- * @return The generated FA
+ * @param postfix The tokens of the RE in postfix form
+ * @param automaton The FA where the fragment is built
+ * @return The generated fragment
  */
-FA getSubExFA(std::string re, FA* automaton, int* reading_index, int* state_name_differ) {
-    if (*reading_index > re.size()-1) {
-        return *automaton;
-    }
-    char c = re[*reading_index];
-    
-    switch (c) {
-    case '+':
-        {
-            *reading_index = *reading_index + 1;
-            FA sub_automaton = FA(
-                {std::to_string(*state_name_differ)},
-                std::set<std::string>(),
-                std::map<transition, std::set<state>>(),
-                std::to_string(*state_name_differ),
-                {std::to_string(*state_name_differ)}
-            );
-            *state_name_differ = *state_name_differ + 1;
-            sub_automaton = getSubExFA(re,&sub_automaton,reading_index,state_name_differ);
-            *state_name_differ = *state_name_differ + 1;
-            *automaton = uniteAutomatons(*automaton,sub_automaton,state_name_differ);
-            *state_name_differ = *state_name_differ + 1;
-            break;
-        }
-    case ')':
-        *reading_index = *reading_index + 1;
-        return *automaton;
-        break;
-    case '(':
-        {
-            *reading_index = *reading_index + 1;
-            FA sub_automaton = FA(
-                {"0"},
-                std::set<std::string>(),
-                std::map<transition, std::set<state>>(),
-                "0",
-                {"0"}
-            );
-            sub_automaton = getSubExFA(re,&sub_automaton,reading_index,state_name_differ);
-            *state_name_differ = *state_name_differ + 1;
-
-            // Kleene star
-            if (re[*reading_index] == '*') {
-                *reading_index = *reading_index + 1;
-                sub_automaton = kleeneStar(sub_automaton,state_name_differ);
-                *state_name_differ = *state_name_differ + 1;
-            }
+nfaFragment getPostfixFragment(std::vector<reToken>& postfix, FA* automaton) {
+    std::vector<nfaFragment> operands;
 
-            *automaton = concatAutomatons(*automaton,sub_automaton,state_name_differ);
-            *state_name_differ = *state_name_differ + 1;
+    for (reToken token : postfix) {
+        switch (token.type) {
+        case RE_SYMBOL:
+            operands.push_back(singleCharFragment(automaton, std::string(1, token.symbol)));
             break;
-        }
-    default:
-        {
-            automaton->addSymbol(std::string(1,c));
-
-            std::string symbol_string = std::string(1,c);
-
-            FA sub_automaton = singleCharAutomaton(symbol_string,state_name_differ);
-            *state_name_differ = *state_name_differ + 1;
-
-            // Kleene star
-            if (re[*reading_index+1] == '*') {
-                *reading_index = *reading_index + 1;
-                sub_automaton = kleeneStar(sub_automaton,state_name_differ);
-                *state_name_differ = *state_name_differ + 1;
-            }
-
-            *automaton = concatAutomatons(*automaton, sub_automaton, state_name_differ);
-            *state_name_differ = *state_name_differ + 1;
-
+        case RE_EMPTY:
+            operands.push_back(emptyFragment(automaton));
             break;
+        case RE_STAR:
+            operands.back() = kleeneStarFragment(automaton, operands.back());
+            break;
+        case RE_CONCAT:
+        case RE_UNION:
+            {
+                nfaFragment right_fragment = operands.back();
+                operands.pop_back();
+                nfaFragment left_fragment = operands.back();
+                if (token.type == RE_CONCAT) {
+                    operands.back() = concatFragments(automaton, left_fragment, right_fragment);
+                } else {
+                    operands.back() = uniteFragments(automaton, left_fragment, right_fragment);
+                }
+                break;
+            }
         }
     }
-    *reading_index = *reading_index + 1;
-    return getSubExFA(re, automaton, reading_index, state_name_differ);
+
+    return operands.back();
 }
 
 /**
- * @brief Generates a Finite Automaton based on a Regular Expression
+ * @brief Generates a Finite Automaton based on a Regular Expression with Thompson's
+ * construction, in time linear on the size of the RE
  * 
  * @param re The Regular Expression
- * @return A Finite Automaton based on the Regular Expression
+ * @return A Finite Automaton based on the Regular Expression. An empty FA if the RE is invalid
  */
 FA getFAFromRE(std::string re) {
-    int state_name_differ = 0;
-    int reading_index = 0;
-    
+    FA automaton = FA();
+
     // Invalid RE
     if (re[0] == ')' || re[0] == '*' || re[0] == '+') return FA();
 
-    FA automaton = FA(
-        {"0"},
-        std::set<std::string>(),
-        std::map<transition, std::set<state>>(),
-        "0",
-        {"0"}
-    );
-    automaton = getSubExFA(re, &automaton, &reading_index, &state_name_differ);
+    std::vector<reToken> postfix;
+    try {
+        postfix = parseRegularExpression(re);
+    } catch (const std::invalid_argument& e) {
+        return FA();
+    }
 
-    automaton.renameAutomatonStates();
+    nfaFragment fragment = getPostfixFragment(postfix, &automaton);
+    automaton.setInitialStateId(fragment.start);
+    automaton.setFinalStateId(fragment.end);
 
     return automaton;
 }
 
 /**
- * @brief Removes all lambda transitions from a FA
+ * @brief Transforms a list of Regular Expressions into a single multi-pattern Finite
+ * Automaton. The automaton of each RE is built with Thompson's construction as in
+ * getFAFromRE, and a new initial state goes by λ to all of them. The final state of the i-th
+ * RE accepts the pattern i
+ * 
+ * @param res The Regular Expressions
+ * @return A multi-pattern Finite Automaton that accepts the union of the REs
+ * @throws std::invalid_argument If any of the REs is invalid
+ */
+FA getFAFromREs(const std::vector<std::string>& res) {
+    FA automaton = FA();
+    stateId initial_state = automaton.newState();
+    automaton.setInitialStateId(initial_state);
+
+    for (patternId pattern = 0; pattern < res.size(); pattern++) {
+        const std::string& re = res[pattern];
+        if (re[0] == ')' || re[0] == '*' || re[0] == '+') {
+            throw std::invalid_argument("Invalid regular expression " + std::to_string(pattern) + ": " + re);
+        }
+
+        std::vector<reToken> postfix;
+        try {
+            postfix = parseRegularExpression(re);
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("Invalid regular expression " + std::to_string(pattern) + ": " + re);
+        }
+
+        nfaFragment fragment = getPostfixFragment(postfix, &automaton);
+        automaton.addTransitionId(initial_state, LAMBDA, fragment.start);
+        automaton.addAcceptId(fragment.end, pattern);
+    }
+
+    return automaton;
+}
+
+/**
+ * @brief Removes all lambda transitions from a FA. All the lambda closures are computed at
+ * once by LambdaClosure, and since the states of a strongly connected component of lambda
+ * transitions have the same closure, δ' is computed once per component
  * 
  * @param fa The FA to be transformed
  * @return The transformed FA
  */
-FA removeLambdaTransitions(FA fa) {
+FA removeLambdaTransitions(const FA& fa) {
     if (!fa.hasLambda()) {
         return fa;
     }
 
     // Step 1
     // Get all fechos lambda
-    std::set<std::pair<state,std::set<state>>> fechos_lambda = std::set<std::pair<state,std::set<state>>>();
-    for (auto state : fa.getStates()) {
-        fechos_lambda.insert(std::make_pair(state,fa.getStatesFromLambdaTransition(state)));
-    }
-    
+    LambdaClosure fechos_lambda = LambdaClosure(fa);
+
     // Step 2
     // Creating δ' transitions
-    std::map<transition, std::set<state>> new_transitions = std::map<transition, std::set<state>>();
-    for (state s : fa.getStates()) {
-
-        // Getting current fecho lambda
-        std::set<state> fecho_lambda = std::set<state>();
-        for (std::pair<state,std::set<state>> p : fechos_lambda) {
-            if (p.first == s) {
-                fecho_lambda = p.second;
-                break;
-            }
-        }
+    FA newFa = fa;
+    newFa.clearTransitions();
+
+    std::vector<uint32_t> marks(fa.getStateCount(), 0);
+    std::vector<uint32_t> component_marks(fechos_lambda.getComponentCount(), 0);
+    uint32_t generation = 0;
+    std::vector<stateList> component_states(fechos_lambda.getComponentCount());
+    for (stateId s = 0; s < fa.getStateCount(); s++) {
+        component_states[fechos_lambda.getComponent(s)].push_back(s);
+    }
+
+    stateList set_union;
+    for (uint32_t component = 0; component < fechos_lambda.getComponentCount(); component++) {
+        stateSpan fecho_lambda = fechos_lambda.getComponentClosure(component);
 
         // For each symbol in the alphabet
-        for (std::string symbol : fa.getAlphabet()) {
+        for (symbolId symbol = 1; symbol < fa.getSymbolCount(); symbol++) {
+            if (!fa.isAlphabetSymbol(symbol)) continue;
 
-            // fλ(δ(s,a))
-            std::set<std::set<state>> set_of_fechos = std::set<std::set<state>>();
-            for (auto element : fecho_lambda) {
+            // δ'(s,a) = U fλ(δ(s,a))
+            generation++;
+            set_union.clear();
+            for (stateId element : fecho_lambda) {
                 // δ(s,a)
-                for (state s : fa.transite(element,symbol)) {
-                    set_of_fechos.insert(fa.getStatesFromLambdaTransition(s));
+                for (stateId t : fa.transiteId(element, symbol)) {
+                    uint32_t t_component = fechos_lambda.getComponent(t);
+                    if (component_marks[t_component] == generation) continue;
+                    component_marks[t_component] = generation;
+                    // fλ(δ(s,a))
+                    for (stateId u : fechos_lambda.getComponentClosure(t_component)) {
+                        if (marks[u] != generation) {
+                            marks[u] = generation;
+                            set_union.push_back(u);
+                        }
+                    }
                 }
             }
+            if (set_union.empty()) continue;
+            std::sort(set_union.begin(), set_union.end());
 
-            // Union of all fλ(δ(s,a))
-            std::set<state> set_union = std::set<state>();
-            for (std::set<state> fecho : set_of_fechos) {
-                set_union = getSetUnion(set_union, fecho);
+            for (stateId s : component_states[component]) {
+                newFa.setTransitionsId(s, symbol, set_union);
             }
-
-            // δ'(s,a) = U fλ(δ(s,a))
-            new_transitions[std::make_pair(s, symbol)] = set_union;
         }
     }
 
     // Step 3
-    // Updating final states
-    std::set<state> new_final_states = fa.getFinalStates();
-    std::set<state> initial_state_fecho = fa.getStatesFromLambdaTransition(fa.getInitialState());
-    bool has_final_state = false;
-    for (state s : initial_state_fecho) {
-
-        if (fa.isFinalState(s)) {
-            has_final_state = true;
-            break;
+    // Updating final states. The initial state also accepts the patterns of the final states
+    // in its closure
+    stateId initial_state = fa.getInitialStateId();
+    if (initial_state != NO_STATE) {
+        for (stateId s : fechos_lambda.getClosure(initial_state)) {
+            if (fa.isFinalStateId(s)) {
+                newFa.setFinalStateId(initial_state);
+                for (patternId pattern : fa.getAcceptIds(s)) {
+                    newFa.addAcceptId(initial_state, pattern);
+                }
+            }
         }
     }
-    if (has_final_state) {
-        new_final_states.insert(fa.getInitialState());
-    }
 
     // Step 4
     // Creating new FA
-    return FA(fa.getStates(),
-        fa.getAlphabet(),
-        new_transitions,
-        fa.getInitialState(),
-        new_final_states);
+    return newFa;
 }
 
 /**
  * @brief Transforms a Non-Deterministic Finite Automaton into a Deterministic Finite Automaton
+ * with the subset construction. Only the super states reachable from the initial state are
+ * created: each new super state goes to a worklist and is expanded exactly once. The states of
+ * the DFA are named after the order in which they were discovered, so the initial state is "0"
  * 
  * @param fa The FA to be transformed
  * @return The transformed FA
  */
-FA determinizeFA(FA fa) {
+FA determinizeFA(const FA& fa) {
     if (fa.hasLambda()) {
-        fa = removeLambdaTransitions(fa);
+        FA nfa = removeLambdaTransitions(fa);
+        return determinizeFA(nfa);
     }
 
-    SuperFA superFa = SuperFA();
+    FA newFa = FA();
+    if (fa.getInitialStateId() == NO_STATE) {
+        return newFa;
+    }
 
-    // Step 1
-    // Get transitions and create new required super states
-    for (auto transition : fa.getTransitions()) {
-        superFa.addState({transition.first.first});
-        superFa.addState(transition.second);
-        superFa.addTransition({transition.first.first}, transition.first.second, transition.second);
+    // Setting up alphabet
+    std::vector<symbolId> new_symbols(fa.getSymbolCount(), NO_SYMBOL);
+    for (symbolId a = 1; a < fa.getSymbolCount(); a++) {
+        if (fa.isAlphabetSymbol(a)) {
+            newFa.addSymbol(fa.getSymbolName(a));
+        }
+        new_symbols[a] = newFa.internSymbol(fa.getSymbolName(a));
     }
 
+    // Step 1
+    // The initial super state starts the worklist. Super state i of the table is state i of
+    // the DFA, so the worklist is just the table past the super states already expanded
+    SubsetTable super_states = SubsetTable();
+    bool inserted;
+    super_states.intern({fa.getInitialStateId()}, &inserted);
+    newFa.setInitialStateId(newFa.internState("0"));
+
     // Step 2
-    // Create new transitions based on new super states  
-    for (auto ss : superFa.getStates()) {
-        // Case it is a normal transition
-        if (ss.size() < 2) {
-            continue;
+    // Expand each super state by each symbol: δ'(S,a) = U δ(s,a) for s in S
+    std::vector<uint32_t> marks(fa.getStateCount(), 0);
+    uint32_t generation = 0;
+    stateList target;
+    for (uint32_t current = 0; current < super_states.size(); current++) {
+        // Copied, since interning new super states may move the pool
+        const stateId* states = super_states.getStates(current);
+        stateList current_states(states, states + super_states.getSize(current));
+
+        // A super state is final for every pattern of its final states
+        for (stateId s : current_states) {
+            if (fa.isFinalStateId(s)) {
+                newFa.setFinalStateId(current);
+                for (patternId pattern : fa.getAcceptIds(s)) {
+                    newFa.addAcceptId(current, pattern);
+                }
+            }
         }
-        for (auto symbol : fa.getAlphabet()) {
-            superState objSs = superState();
-            for (auto s : ss) {
-                superState toSs = superFa.transite({s}, symbol);
-                objSs = getSetUnion(objSs, toSs);
+
+        for (symbolId a = 1; a < fa.getSymbolCount(); a++) {
+            generation++;
+            target.clear();
+            for (stateId s : current_states) {
+                for (stateId t : fa.transiteId(s, a)) {
+                    if (marks[t] != generation) {
+                        marks[t] = generation;
+                        target.push_back(t);
+                    }
+                }
             }
             // Case the transition does not exist
-            if (objSs.size() == 0) {
+            if (target.empty()) {
                 continue;
             }
-            superFa.addState(objSs);
-            superFa.addTransition(ss, symbol, objSs);
+            std::sort(target.begin(), target.end());
+
+            uint32_t next = super_states.intern(target, &inserted);
+            if (inserted) {
+                newFa.internState(std::to_string(next));
+            }
+            newFa.addTransitionId(current, new_symbols[a], next);
         }
     }
-    
-    // Step 3
-    // Update final states and initial state
-    for (auto ss : superFa.getStates()) {
-        for (auto s : ss) {
-            if (fa.isFinalState(s)) {
-                superFa.addFinalState(ss);
-                break;
+
+    return newFa;
+}
+
+/**
+ * @brief Builds a FA that accepts the reverse of the language of another FA: every transition
+ * is reversed, a new initial state goes by λ to the old final states and the old initial state
+ * becomes the only final state. If unanchored, the new initial state also loops on every symbol
+ * of the alphabet, so the FA accepts Σ*·reverse(L), that is, every reversed text that ends with
+ * the reverse of a sentence of L
+ * 
+ * @param fa The FA to be reversed
+ * @param unanchored Whether to accept any prefix before the reversed sentence
+ * @return The reversed FA, with λ-transitions
+ */
+FA reverseFA(const FA& fa, bool unanchored = false) {
+    FA newFa = FA();
+
+    // Same symbol and state IDs as the original FA
+    for (symbolId a = 1; a < fa.getSymbolCount(); a++) {
+        if (fa.isAlphabetSymbol(a)) {
+            newFa.addSymbol(fa.getSymbolName(a));
+        } else {
+            newFa.internSymbol(fa.getSymbolName(a));
+        }
+    }
+    for (const state& s : fa.getStateNames()) {
+        newFa.internState(s);
+    }
+
+    for (transitionId t : fa.getTransitionView()) {
+        newFa.addTransitionId(t.to, t.read, t.from);
+    }
+
+    stateId initial_state = newFa.newState();
+    newFa.setInitialStateId(initial_state);
+    for (stateId s = 0; s < fa.getStateCount(); s++) {
+        if (fa.isFinalStateId(s)) {
+            newFa.addTransitionId(initial_state, LAMBDA, s);
+        }
+    }
+    if (unanchored) {
+        for (symbolId a = 1; a < fa.getSymbolCount(); a++) {
+            if (fa.isAlphabetSymbol(a)) {
+                newFa.addTransitionId(initial_state, a, initial_state);
             }
         }
     }
-    superFa.setInitialState({fa.getInitialState()});
+    if (fa.getInitialStateId() != NO_STATE) {
+        newFa.setFinalStateId(fa.getInitialStateId());
+    }
 
-    // Step 4
-    // Create new SuperFA
-    // Creating alphabet
-    for (std::string symbol : fa.getAlphabet()) {
-        superFa.addSymbol(symbol);
+    return newFa;
+}
+
+/**
+ * @brief Transforms a FA into an equivalent homogeneous NFA without λ-transitions, where all
+ * the transitions that reach a state read the same symbol, as in the position (Glushkov)
+ * automaton of a RE. Only the initial state and the targets of transitions by symbols are
+ * kept: each one is split in one copy per symbol that reaches it, and reads what the states of
+ * its lambda closure read. Copies are only created for states that are reachable and can reach
+ * a final state, so for the automaton of a RE there is about one state per symbol of the RE
+ * 
+ * @param fa The FA to be transformed
+ * @param max_states The maximum number of states of the result
+ * @return The homogeneous NFA. An empty FA if it would have more than max_states states
+ */
+FA homogenizeFA(const FA& fa, size_t max_states = SIZE_MAX) {
+    FA newFa = FA();
+    if (fa.getInitialStateId() == NO_STATE) {
+        return newFa;
     }
 
-    // Step 5
-    // Convert SuperFA to FA
-    FA newFa = superFa.convertToFa();
+    // Same symbol IDs as the original FA
+    size_t symbol_count = fa.getSymbolCount();
+    for (symbolId a = 1; a < symbol_count; a++) {
+        if (fa.isAlphabetSymbol(a)) {
+            newFa.addSymbol(fa.getSymbolName(a));
+        } else {
+            newFa.internSymbol(fa.getSymbolName(a));
+        }
+    }
 
-    newFa.renameAutomatonStates();
+    LambdaClosure closures = LambdaClosure(fa);
+
+    // Live states: the ones that can reach a final state
+    std::vector<stateList> predecessors(fa.getStateCount());
+    for (transitionId t : fa.getTransitionView()) {
+        predecessors[t.to].push_back(t.from);
+    }
+    std::vector<bool> live(fa.getStateCount(), false);
+    stateList live_worklist;
+    for (stateId s = 0; s < fa.getStateCount(); s++) {
+        if (fa.isFinalStateId(s)) {
+            live[s] = true;
+            live_worklist.push_back(s);
+        }
+    }
+    while (!live_worklist.empty()) {
+        stateId s = live_worklist.back();
+        live_worklist.pop_back();
+        for (stateId p : predecessors[s]) {
+            if (!live[p]) {
+                live[p] = true;
+                live_worklist.push_back(p);
+            }
+        }
+    }
+
+    // copy_of[t * symbol_count + a] is the copy of t reached by a. The LAMBDA column holds the
+    // copy of the initial state
+    std::vector<stateId> copy_of(fa.getStateCount() * symbol_count, NO_STATE);
+    std::vector<std::pair<stateId, stateId>> worklist;
+
+    // A copy is final if there is a final state in the closure of its state
+    auto isFinalClosure = [&](stateId s) {
+        for (stateId u : closures.getClosure(s)) {
+            if (fa.isFinalStateId(u)) return true;
+        }
+        return false;
+    };
+
+    stateId initial_state = fa.getInitialStateId();
+    stateId initial_copy = newFa.newState();
+    newFa.setInitialStateId(initial_copy);
+    newFa.setFinalStateId(initial_copy, isFinalClosure(initial_state));
+    copy_of[initial_state * symbol_count + LAMBDA] = initial_copy;
+    worklist.push_back(std::make_pair(initial_state, initial_copy));
+
+    while (!worklist.empty()) {
+        stateId s = worklist.back().first;
+        stateId s_copy = worklist.back().second;
+        worklist.pop_back();
+
+        for (stateId u : closures.getClosure(s)) {
+            for (symbolId a = 1; a < symbol_count; a++) {
+                for (stateId t : fa.transiteId(u, a)) {
+                    if (!live[t]) continue;
+                    stateId& t_copy = copy_of[t * symbol_count + a];
+                    if (t_copy == NO_STATE) {
+                        if (newFa.getStateCount() >= max_states) {
+                            return FA();
+                        }
+                        t_copy = newFa.newState();
+                        newFa.setFinalStateId(t_copy, isFinalClosure(t));
+                        worklist.push_back(std::make_pair(t, t_copy));
+                    }
+                    newFa.addTransitionId(s_copy, a, t_copy);
+                }
+            }
+        }
+    }
 
     return newFa;
-}
\ No newline at end of file
+}
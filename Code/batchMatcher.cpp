@@ -0,0 +1,157 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include "matcher.cpp"
+
+// Number of sentences matched by a worker at a time
+const size_t BATCH_CHUNK_SIZE = 4096;
+// Size of the buffer of the BufferedWriter
+const size_t WRITER_BUFFER_SIZE = 1 << 16;
+
+/**
+ * @brief How the results of testSentencesInParallel are written
+ */
+enum resultFormat {
+    // A "Sentence: ... => Accepted." line per sentence, for people
+    TEXT_RESULTS,
+    // A "1<TAB>sentence" or "0<TAB>sentence" line per sentence, for programs
+    TSV_RESULTS
+};
+
+/**
+ * @brief Writes text to a stream in large blocks, instead of one small write per result
+ */
+class BufferedWriter {
+private:
+    std::ostream* out;
+    std::string buffer;
+
+public:
+    // Constructors
+    BufferedWriter(std::ostream& out) {
+        this->out = &out;
+        this->buffer = std::string();
+        this->buffer.reserve(WRITER_BUFFER_SIZE);
+    }
+
+    ~BufferedWriter() {
+        this->flush();
+    }
+
+    /**
+     * @brief Writes text to the buffer, flushing it when it is full
+     * 
+     * @param text The text to be written
+     */
+    void write(const std::string& text) {
+        if (this->buffer.size() + text.size() > WRITER_BUFFER_SIZE) {
+            this->flush();
+        }
+        if (text.size() > WRITER_BUFFER_SIZE) {
+            this->out->write(text.data(), text.size());
+        } else {
+            this->buffer += text;
+        }
+    }
+
+    /**
+     * @brief Writes everything in the buffer to the stream
+     */
+    void flush() {
+        if (!this->buffer.empty()) {
+            this->out->write(this->buffer.data(), this->buffer.size());
+            this->buffer.clear();
+        }
+        this->out->flush();
+    }
+};
+
+/**
+ * @brief Tests a list of sentences with a pool of threads that share the same Matcher. The
+ * sentences are split in chunks that the workers take in order, and the results of each chunk
+ * are written by the calling thread as soon as the chunk and all the ones before it are done,
+ * so the output keeps the order of the input. Each worker keeps its own LazyDfa cache
+ * 
+ * @param matcher The Matcher
+ * @param sentences The views of the sentences to be tested
+ * @param writer The writer of the results
+ * @param thread_count The number of workers. 0 to use one per hardware thread
+ * @param format How the results are written
+ * @return The number of accepted sentences
+ */
+size_t testSentencesInParallel(const Matcher& matcher, const std::vector<std::string_view>& sentences, BufferedWriter& writer, unsigned thread_count = 0, resultFormat format = TEXT_RESULTS) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t chunk_count = (sentences.size() + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+    thread_count = std::min<size_t>(thread_count, std::max<size_t>(chunk_count, 1));
+
+    std::vector<std::string> chunk_outputs(chunk_count);
+    std::vector<bool> chunk_done(chunk_count, false);
+    std::atomic<size_t> next_chunk(0);
+    std::atomic<size_t> accepted(0);
+    std::mutex done_mutex;
+    std::condition_variable done_condition;
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < thread_count; t++) {
+        workers.push_back(std::thread([&]() {
+            LazyDfa cache = matcher.getLazyDfa();
+            size_t chunk;
+            while ((chunk = next_chunk.fetch_add(1)) < chunk_count) {
+                size_t end = std::min(sentences.size(), (chunk + 1) * BATCH_CHUNK_SIZE);
+                std::string output;
+                size_t chunk_accepted = 0;
+                for (size_t i = chunk * BATCH_CHUNK_SIZE; i < end; i++) {
+                    bool is_accepted = matcher.matches(sentences[i].data(), sentences[i].size(), cache);
+                    chunk_accepted += is_accepted;
+                    if (format == TSV_RESULTS) {
+                        output += is_accepted ? "1\t" : "0\t";
+                        output.append(sentences[i].data(), sentences[i].size());
+                        output += '\n';
+                        continue;
+                    }
+                    output += "\nSentence: ";
+                    output.append(sentences[i].data(), sentences[i].size());
+                    output += is_accepted ? " => Accepted." : " => Rejected.";
+                }
+                accepted += chunk_accepted;
+
+                std::lock_guard<std::mutex> lock(done_mutex);
+                chunk_outputs[chunk] = std::move(output);
+                chunk_done[chunk] = true;
+                done_condition.notify_all();
+            }
+        }));
+    }
+
+    // Writing the results in order
+    for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+        std::string output;
+        {
+            std::unique_lock<std::mutex> lock(done_mutex);
+            done_condition.wait(lock, [&]() { return chunk_done[chunk]; });
+            output = std::move(chunk_outputs[chunk]);
+        }
+        writer.write(output);
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    writer.flush();
+
+    return accepted;
+}
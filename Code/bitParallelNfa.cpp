@@ -0,0 +1,211 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include "fa.cpp"
+
+// Number of states of the NFA that are grouped in each chunk of the follow table
+const size_t BIT_PARALLEL_CHUNK_BITS = 8;
+
+/**
+ * @brief A homogeneous NFA (see homogenizeFA) simulated with bit-parallelism, in the style of
+ * Shift-And on Glushkov automatons. The set of active states is a bitmask of WORDS machine
+ * words, so the NFA can have up to 64 * WORDS states. Since all the transitions that reach a
+ * state read the same symbol, one step of the simulation is
+ * 
+ *     D' = Follow(D) & B[symbol]
+ * 
+ * where B[symbol] is the mask of the states reached by the symbol and Follow(D) is the union of
+ * the successors of the states of D. Follow(D) is read from a table indexed by chunks of 8 bits
+ * of D, so each input byte costs a few loads, ANDs and ORs, without any determinization.
+ * 
+ * A BitParallelNfa is never modified after it is built, so one instance can be shared by any
+ * number of threads.
+ */
+template <size_t WORDS>
+class BitParallelNfa {
+private:
+    typedef std::array<uint64_t, WORDS> stateMask;
+
+    size_t chunk_count;
+    std::array<symbolId, 256> byte_symbols;
+    // symbol_masks[symbol] is the mask of the states reached by symbol
+    std::vector<stateMask> symbol_masks;
+    // follow_table[chunk * 256 + bits] is the union of the successors of the states of the
+    // chunk whose bits are set
+    std::vector<stateMask> follow_table;
+    stateMask initial_mask;
+    stateMask final_mask;
+
+    /**
+     * @brief Runs the NFA over a sentence
+     * 
+     * @param length The length of the sentence
+     * @param symbol_at A function that gets the ID of the i-th symbol of the sentence, or
+     * NO_SYMBOL if it is not a symbol of the NFA
+     * @return true if the sentence is accepted. false otherwise
+     */
+    template <typename SymbolAt>
+    bool run(size_t length, SymbolAt symbol_at) const {
+        const stateMask* follow_table = this->follow_table.data();
+        stateMask active = this->initial_mask;
+
+        for (size_t i = 0; i < length; i++) {
+            symbolId symbol = symbol_at(i);
+            if (symbol == NO_SYMBOL) {
+                return false;
+            }
+
+            stateMask next;
+            next.fill(0);
+            for (size_t word = 0; word < WORDS; word++) {
+                // Chunks of inactive states add nothing
+                uint64_t active_word = active[word];
+                for (size_t chunk = word * 8; active_word != 0; chunk++, active_word >>= BIT_PARALLEL_CHUNK_BITS) {
+                    const stateMask& entry = follow_table[chunk * 256 + (active_word & 0xFF)];
+                    for (size_t w = 0; w < WORDS; w++) {
+                        next[w] |= entry[w];
+                    }
+                }
+            }
+
+            const stateMask& symbol_mask = this->symbol_masks[symbol];
+            uint64_t any = 0;
+            for (size_t w = 0; w < WORDS; w++) {
+                active[w] = next[w] & symbol_mask[w];
+                any |= active[w];
+            }
+            if (!any) {
+                return false;
+            }
+        }
+
+        for (size_t w = 0; w < WORDS; w++) {
+            if (active[w] & this->final_mask[w]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    // Constructors
+    BitParallelNfa() {
+        this->chunk_count = 0;
+        this->byte_symbols.fill(NO_SYMBOL);
+        this->symbol_masks = std::vector<stateMask>();
+        this->follow_table = std::vector<stateMask>();
+        this->initial_mask.fill(0);
+        this->final_mask.fill(0);
+    }
+
+    /**
+     * @brief Builds the masks and the follow table of a homogeneous NFA
+     * 
+     * @param nfa The NFA. It must be homogeneous, without λ-transitions and with at most
+     * 64 * WORDS states
+     * @throws std::invalid_argument If the NFA has too many states or is not homogeneous
+     */
+    BitParallelNfa(const FA& nfa) : BitParallelNfa() {
+        size_t state_count = nfa.getStateCount();
+        if (state_count > 64 * WORDS) {
+            throw std::invalid_argument("The NFA has too many states for a bit-parallel simulation.");
+        }
+        if (nfa.hasLambda()) {
+            throw std::invalid_argument("The NFA has lambda transitions.");
+        }
+
+        stateMask empty_mask;
+        empty_mask.fill(0);
+        this->byte_symbols = nfa.getByteSymbols();
+        this->symbol_masks = std::vector<stateMask>(nfa.getSymbolCount(), empty_mask);
+        this->chunk_count = (state_count + BIT_PARALLEL_CHUNK_BITS - 1) / BIT_PARALLEL_CHUNK_BITS;
+        this->follow_table = std::vector<stateMask>(this->chunk_count * 256, empty_mask);
+
+        std::vector<symbolId> reached_by(state_count, NO_SYMBOL);
+        std::vector<stateMask> follow(state_count, empty_mask);
+        for (transitionId t : nfa.getTransitionView()) {
+            if (reached_by[t.to] != NO_SYMBOL && reached_by[t.to] != t.read) {
+                throw std::invalid_argument("The NFA is not homogeneous.");
+            }
+            reached_by[t.to] = t.read;
+            this->symbol_masks[t.read][t.to / 64] |= ((uint64_t) 1) << (t.to % 64);
+            follow[t.from][t.to / 64] |= ((uint64_t) 1) << (t.to % 64);
+        }
+
+        for (size_t chunk = 0; chunk < this->chunk_count; chunk++) {
+            for (size_t bits = 1; bits < 256; bits++) {
+                // Built from the entry without the lowest bit
+                size_t lowest = 0;
+                while (!((bits >> lowest) & 1)) {
+                    lowest++;
+                }
+                stateId s = chunk * BIT_PARALLEL_CHUNK_BITS + lowest;
+                stateMask& entry = this->follow_table[chunk * 256 + bits];
+                entry = this->follow_table[chunk * 256 + (bits & (bits - 1))];
+                if (s < state_count) {
+                    for (size_t w = 0; w < WORDS; w++) {
+                        entry[w] |= follow[s][w];
+                    }
+                }
+            }
+        }
+
+        stateId initial_state = nfa.getInitialStateId();
+        if (initial_state != NO_STATE) {
+            this->initial_mask[initial_state / 64] |= ((uint64_t) 1) << (initial_state % 64);
+        }
+        for (stateId s = 0; s < state_count; s++) {
+            if (nfa.isFinalStateId(s)) {
+                this->final_mask[s / 64] |= ((uint64_t) 1) << (s % 64);
+            }
+        }
+    }
+
+    // Matching
+    /**
+     * @brief Tests if a sentence is accepted by the NFA
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool matches(const char* sentence, size_t length) const {
+        const unsigned char* input = (const unsigned char*) sentence;
+        return this->run(length, [&](size_t i) {
+            return this->byte_symbols[input[i]];
+        });
+    }
+
+    /**
+     * @brief Tests if a sentence, already split into symbols, is accepted by the NFA
+     * 
+     * @param symbols The IDs of the symbols of the sentence, as in the NFA
+     * @param length The number of symbols
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool matchesSymbols(const symbolId* symbols, size_t length) const {
+        size_t symbol_count = this->symbol_masks.size();
+        return this->run(length, [&](size_t i) {
+            return symbols[i] < symbol_count ? symbols[i] : NO_SYMBOL;
+        });
+    }
+
+    /**
+     * @brief Tests if a sentence is accepted by the NFA
+     * 
+     * @param sentence The sentence to be tested
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool testSentence(const std::string& sentence) const {
+        return this->matches(sentence.data(), sentence.length());
+    }
+};
@@ -0,0 +1,288 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cctype>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include "fa.cpp"
+#include "compiledDfa.cpp"
+
+/**
+ * @brief The shapes of the C++ code a DFA can be generated as
+ */
+enum codeStyle {
+    // Every state is a label and every transition a goto, chosen by a switch on the next byte
+    SWITCH_CODE,
+    // A static constexpr transition table over symbol classes, read by a constexpr function
+    TABLE_CODE
+};
+
+// The keywords and alternative tokens of C++, which can not be used as identifiers
+const char* const CPP_KEYWORDS[] = {
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break",
+    "case", "catch", "char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept",
+    "const", "consteval", "constexpr", "constinit", "const_cast", "continue", "co_await",
+    "co_return", "co_yield", "decltype", "default", "delete", "do", "double", "dynamic_cast",
+    "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+    "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+    "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register",
+    "reinterpret_cast", "requires", "return", "short", "signed", "sizeof", "static",
+    "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local",
+    "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using",
+    "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+};
+
+/**
+ * @brief Checks if a name can be used as the name of a namespace. Keywords are rejected, and
+ * so are the names reserved to the implementation: the ones with a double underscore and,
+ * since the namespace is global, the ones that start with an underscore
+ * 
+ * @param name The name
+ * @return true if the name is a valid identifier. false otherwise
+ */
+bool isCppIdentifier(const std::string& name) {
+    if (name.empty() || std::isdigit((unsigned char) name[0]) || name[0] == '_') {
+        return false;
+    }
+    for (char c : name) {
+        if (!std::isalnum((unsigned char) c) && c != '_') {
+            return false;
+        }
+    }
+    if (name.find("__") != std::string::npos) {
+        return false;
+    }
+    for (const char* keyword : CPP_KEYWORDS) {
+        if (name == keyword) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Writes a byte as a C++ case label
+ * 
+ * @param byte The byte
+ * @return The character literal for letters and digits, the number otherwise
+ */
+std::string getCppByteLiteral(unsigned char byte) {
+    if (std::isalnum(byte)) {
+        return std::string("'") + (char) byte + "'";
+    }
+    return std::to_string(byte);
+}
+
+/**
+ * @brief Gets the smallest unsigned type that holds a value
+ * 
+ * @param max_value The value
+ * @return The name of the type
+ */
+std::string getCppIndexType(uint32_t max_value) {
+    if (max_value <= UINT8_MAX) {
+        return "std::uint8_t";
+    }
+    if (max_value <= UINT16_MAX) {
+        return "std::uint16_t";
+    }
+    return "std::uint32_t";
+}
+
+/**
+ * @brief Writes the body of the match function of a DFA as a state machine: each state is a
+ * label, and reading a byte is a switch whose cases jump straight to the next state. States that
+ * can not reach a final state reject at once
+ * 
+ * @param dfa The DFA
+ * @param code The stream the code is written to
+ */
+void generateSwitchCode(const FA& dfa, std::ostringstream& code) {
+    // States that can reach a final state
+    std::vector<stateList> predecessors(dfa.getStateCount());
+    for (transitionId t : dfa.getTransitionView()) {
+        predecessors[t.to].push_back(t.from);
+    }
+    std::vector<bool> live(dfa.getStateCount(), false);
+    stateList worklist;
+    for (stateId s = 0; s < dfa.getStateCount(); s++) {
+        if (dfa.isFinalStateId(s)) {
+            live[s] = true;
+            worklist.push_back(s);
+        }
+    }
+    while (!worklist.empty()) {
+        stateId s = worklist.back();
+        worklist.pop_back();
+        for (stateId p : predecessors[s]) {
+            if (!live[p]) {
+                live[p] = true;
+                worklist.push_back(p);
+            }
+        }
+    }
+
+    stateId initial_state = dfa.getInitialStateId();
+    code << "inline bool matches(const char* sentence, std::size_t length) {\n";
+    if (initial_state == NO_STATE || !live[initial_state]) {
+        code << "    return false;\n";
+        code << "}\n";
+        return;
+    }
+
+    // Only the live states reachable from the initial state get a label, so none is unused
+    std::vector<bool> reachable(dfa.getStateCount(), false);
+    reachable[initial_state] = true;
+    worklist.push_back(initial_state);
+    while (!worklist.empty()) {
+        stateId s = worklist.back();
+        worklist.pop_back();
+        for (symbolId a = 1; a < dfa.getSymbolCount(); a++) {
+            for (stateId t : dfa.transiteId(s, a)) {
+                if (live[t] && !reachable[t]) {
+                    reachable[t] = true;
+                    worklist.push_back(t);
+                }
+            }
+        }
+    }
+
+    code << "    const unsigned char* input = reinterpret_cast<const unsigned char*>(sentence);\n";
+    code << "    const unsigned char* end = input + length;\n";
+    code << "    goto q" << initial_state << ";\n";
+
+    for (stateId s = 0; s < dfa.getStateCount(); s++) {
+        if (!reachable[s]) continue;
+
+        // Bytes sorted by the state they go to, so the cases of each state are together
+        std::vector<std::pair<stateId, unsigned char>> edges;
+        for (symbolId a = 1; a < dfa.getSymbolCount(); a++) {
+            const stateList& targets = dfa.transiteId(s, a);
+            if (targets.empty() || !live[targets[0]]) continue;
+            edges.push_back(std::make_pair(targets[0], (unsigned char) dfa.getSymbolName(a)[0]));
+        }
+        std::sort(edges.begin(), edges.end());
+
+        code << "\n// State " << dfa.getStateName(s) << "\n";
+        code << "q" << s << ":\n";
+        code << "    if (input == end) return " << (dfa.isFinalStateId(s) ? "true" : "false") << ";\n";
+        code << "    switch (*input++) {\n";
+        for (size_t i = 0; i < edges.size(); i++) {
+            code << "    case " << getCppByteLiteral(edges[i].second) << ":\n";
+            if (i + 1 == edges.size() || edges[i + 1].first != edges[i].first) {
+                code << "        goto q" << edges[i].first << ";\n";
+            }
+        }
+        code << "    default:\n";
+        code << "        return false;\n";
+        code << "    }\n";
+    }
+    code << "}\n";
+}
+
+/**
+ * @brief Writes the match function of a DFA as a static constexpr transition table over symbol
+ * classes, laid out as in CompiledDfa, and a constexpr function that reads it
+ * 
+ * @param dfa The DFA
+ * @param code The stream the code is written to
+ */
+void generateTableCode(const FA& dfa, std::ostringstream& code) {
+    CompiledDfa compiled = CompiledDfa(dfa);
+    uint32_t state_count = compiled.getStateCount();
+    uint32_t class_count = compiled.getClassCount();
+    std::string index_type = getCppIndexType((state_count - 1) * class_count);
+
+    code << "static constexpr std::uint8_t byte_classes[256] = {";
+    for (size_t byte = 0; byte < 256; byte++) {
+        code << (byte % 16 == 0 ? "\n    " : " ") << (int) compiled.getByteClass(byte) << ",";
+    }
+    code << "\n};\n\n";
+
+    code << "// table[s + c] is the next state of s reading class c. States are premultiplied by the\n";
+    code << "// number of classes, and state 0 is a dead state\n";
+    code << "static constexpr " << index_type << " table[" << state_count * class_count << "] = {";
+    for (uint32_t s = 0; s < state_count; s++) {
+        code << "\n   ";
+        for (uint32_t c = 0; c < class_count; c++) {
+            code << " " << compiled.nextByClass(s * class_count, c) << ",";
+        }
+    }
+    code << "\n};\n\n";
+
+    code << "static constexpr bool accepting[" << state_count << "] = {";
+    for (uint32_t s = 0; s < state_count; s++) {
+        code << (s % 16 == 0 ? "\n    " : " ") << (compiled.isAccepting(s * class_count) ? "true" : "false") << ",";
+    }
+    code << "\n};\n\n";
+
+    code << "static constexpr " << index_type << " initial_state = " << compiled.getInitialState() << ";\n";
+    code << "static constexpr std::size_t class_count = " << class_count << ";\n\n";
+
+    code << "constexpr bool matches(const char* sentence, std::size_t length) {\n";
+    code << "    " << index_type << " s = initial_state;\n";
+    code << "    for (std::size_t i = 0; i < length; i++) {\n";
+    code << "        s = table[s + byte_classes[static_cast<unsigned char>(sentence[i])]];\n";
+    code << "    }\n";
+    code << "    return accepting[s / class_count];\n";
+    code << "}\n";
+}
+
+/**
+ * @brief Generates a self-contained C++17 header that matches the language of a DFA, so it can
+ * be compiled into a program without loading any file at runtime. The header declares, in the
+ * given namespace,
+ * 
+ *     bool matches(const char* sentence, std::size_t length);
+ *     bool matches(std::string_view sentence);
+ * 
+ * which are constexpr in the TABLE_CODE style
+ * 
+ * @param dfa The DFA. It must be deterministic and have only single-character symbols
+ * @param name The namespace of the generated code
+ * @param style The shape of the generated code
+ * @return The content of the header
+ * @throws std::invalid_argument If the DFA can not be generated or the name is not a valid
+ * identifier
+ */
+std::string generateDfaHeader(const FA& dfa, const std::string& name, codeStyle style) {
+    if (!isCppIdentifier(name)) {
+        throw std::invalid_argument("\"" + name + "\" can not be used as a C++ namespace name.");
+    }
+    if (!dfa.isDeterministic()) {
+        throw std::invalid_argument("Only deterministic automatons can be generated.");
+    }
+    for (symbolId a = 1; a < dfa.getSymbolCount(); a++) {
+        if (dfa.getSymbolName(a).length() != 1) {
+            throw std::invalid_argument("Only single-character symbols can be generated.");
+        }
+    }
+
+    std::ostringstream code;
+    code << "// Generated from a DFA with " << dfa.getStateCount() << " states. Do not edit.\n\n";
+    code << "#pragma once\n\n";
+    code << "#include <cstddef>\n";
+    code << "#include <cstdint>\n";
+    code << "#include <string_view>\n\n";
+    code << "namespace " << name << " {\n\n";
+
+    if (style == SWITCH_CODE) {
+        generateSwitchCode(dfa, code);
+        code << "\ninline bool matches(std::string_view sentence) {\n";
+    } else {
+        generateTableCode(dfa, code);
+        code << "\nconstexpr bool matches(std::string_view sentence) {\n";
+    }
+    code << "    return matches(sentence.data(), sentence.size());\n";
+    code << "}\n\n";
+    code << "} // namespace " << name << "\n";
+    return code.str();
+}
@@ -0,0 +1,533 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <array>
+#include <set>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "fa.cpp"
+#include "mappedFile.cpp"
+
+// Identifies the binary files of compiled DFAs
+const char COMPILED_DFA_MAGIC[8] = {'F', 'A', 'C', 'D', 'F', 'A', '\0', '\0'};
+// Version of the binary format, increased whenever the layout changes
+const uint32_t COMPILED_DFA_VERSION = 1;
+// Written in the native byte order, to detect files from machines with another one
+const uint32_t COMPILED_DFA_BYTE_ORDER = 0x01020304;
+
+/**
+ * @brief The header of a binary file of a CompiledDfa. It is followed by the arrays, in this
+ * order and each one starting at a multiple of 8 bytes: symbol_classes (uint8_t),
+ * table (uint32_t), accepting (uint64_t), accept_offsets (uint32_t) and accept_pool (uint32_t),
+ * and then by metadata_size bytes of metadata left to the writer
+ */
+struct compiledDfaFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t state_count;
+    uint32_t class_count;
+    uint32_t initial_state;
+    uint32_t symbol_count;
+    uint32_t accept_pool_size;
+    uint32_t metadata_size;
+    uint8_t byte_classes[256];
+};
+
+/**
+ * @brief A DFA compiled to a dense transition table. Input bytes are first mapped to symbol
+ * classes (bytes with identical columns share a class) and every row of the table holds the
+ * next state for each class, so matching costs a single array load per input byte.
+ * 
+ * State 0 is a dead state that loops to itself on every class, so missing transitions do not
+ * need any branch in the match loop. Only single-character symbols are read from bytes;
+ * sentences with multi-character symbols are split by a SymbolTokenizer and matched with
+ * matchesSymbols().
+ * 
+ * A CompiledDfa can be saved to a binary file and mapped back into memory, where its arrays are
+ * used in place, so loading it costs no parsing and no copies and processes that load the same
+ * file share its pages.
+ * 
+ * A CompiledDfa is never modified after it is built, so one instance can be shared by any
+ * number of threads.
+ */
+class CompiledDfa {
+private:
+    /**
+     * @brief The arrays of a CompiledDfa built in memory
+     */
+    struct tables {
+        std::vector<uint32_t> table;
+        std::vector<uint64_t> accepting;
+        std::vector<uint32_t> accept_offsets;
+        std::vector<patternId> accept_pool;
+    };
+
+    uint32_t state_count;
+    uint32_t class_count;
+    std::array<uint8_t, 256> byte_classes;
+    // symbol_classes[symbol] is the class of the symbol with that ID in the compiled DFA
+    std::vector<uint8_t> symbol_classes;
+    // table[s + c] is the next state of s reading class c. State IDs are premultiplied by the
+    // number of classes, so they are already row offsets
+    const uint32_t* table;
+    const uint64_t* accepting;
+    // The patterns accepted by state s are accept_pool[accept_offsets[s]..accept_offsets[s+1]]
+    const uint32_t* accept_offsets;
+    const patternId* accept_pool;
+    uint32_t accept_pool_size;
+    uint32_t initial_state;
+    // The memory the arrays point to, either tables or a mapped file. It is shared by the
+    // copies of the CompiledDfa and never modified
+    std::shared_ptr<const void> storage;
+
+    /**
+     * @brief Gets where the arrays are in a binary file
+     * 
+     * @param header The header of the file
+     * @param offsets Where the offsets of symbol_classes, table, accepting, accept_offsets,
+     * accept_pool and the metadata are written
+     * @param sizes Where the sizes in bytes of the arrays are written
+     */
+    static void getFileLayout(const compiledDfaFileHeader& header, uint64_t offsets[6], uint64_t sizes[5]) {
+        uint64_t state_count = header.state_count;
+        sizes[0] = header.symbol_count;
+        sizes[1] = state_count * header.class_count * sizeof(uint32_t);
+        sizes[2] = (state_count / 64 + 1) * sizeof(uint64_t);
+        sizes[3] = (state_count + 1) * sizeof(uint32_t);
+        sizes[4] = (uint64_t) header.accept_pool_size * sizeof(patternId);
+        uint64_t offset = sizeof(compiledDfaFileHeader);
+        for (size_t i = 0; i < 5; i++) {
+            offsets[i] = offset;
+            offset = (offset + sizes[i] + 7) / 8 * 8;
+        }
+        offsets[5] = offset;
+    }
+
+    /**
+     * @brief Points the arrays to tables built in memory
+     * 
+     * @param built The tables
+     */
+    void setTables(const std::shared_ptr<const tables>& built) {
+        this->table = built->table.data();
+        this->accepting = built->accepting.data();
+        this->accept_offsets = built->accept_offsets.data();
+        this->accept_pool = built->accept_pool.data();
+        this->accept_pool_size = built->accept_pool.size();
+        this->storage = built;
+    }
+
+public:
+    // Constructors
+    CompiledDfa() {
+        this->state_count = 1;
+        this->class_count = 1;
+        this->byte_classes.fill(0);
+        this->symbol_classes = std::vector<uint8_t>();
+        std::shared_ptr<tables> built = std::make_shared<tables>();
+        built->table = std::vector<uint32_t>(1, 0);
+        built->accepting = std::vector<uint64_t>(1, 0);
+        built->accept_offsets = std::vector<uint32_t>(2, 0);
+        built->accept_pool = std::vector<patternId>();
+        this->setTables(built);
+        this->initial_state = 0;
+    }
+
+    /**
+     * @brief Compiles a DFA
+     * 
+     * @param dfa The DFA to be compiled. It must be deterministic
+     * @throws std::invalid_argument If the DFA is not deterministic
+     * @throws std::length_error If the table has more rows than 32-bit states can index
+     */
+    CompiledDfa(const FA& dfa) : CompiledDfa() {
+        if (!dfa.isDeterministic()) {
+            throw std::invalid_argument("Only deterministic automatons can be compiled.");
+        }
+        if ((uint64_t) dfa.getStateCount() + 1 > UINT32_MAX) {
+            throw std::length_error("The DFA has too many states to be compiled.");
+        }
+
+        this->state_count = dfa.getStateCount() + 1;
+
+        // Grouping the bytes with identical columns in the same class. Class 0 holds the bytes
+        // that are not in the alphabet, whose column is all dead. Each column is stored once, and
+        // the set of classes orders their indices by the columns they point to
+        std::vector<std::vector<uint32_t>> columns;
+        auto compareColumns = [&columns](uint8_t a, uint8_t b) {
+            return columns[a] < columns[b];
+        };
+        std::set<uint8_t, decltype(compareColumns)> classes(compareColumns);
+        columns.push_back(std::vector<uint32_t>(this->state_count, 0));
+        classes.insert(0);
+        this->symbol_classes = std::vector<uint8_t>(dfa.getSymbolCount(), 0);
+        for (size_t symbol = 1; symbol < dfa.getSymbolCount(); symbol++) {
+            const std::string& symbol_name = dfa.getSymbolName(symbol);
+            if (symbol_name.empty()) continue;
+
+            // The column is added as a new class, and dropped if an identical one exists
+            columns.push_back(std::vector<uint32_t>(this->state_count, 0));
+            std::vector<uint32_t>& column = columns.back();
+            for (stateId s = 0; s < dfa.getStateCount(); s++) {
+                const stateList& targets = dfa.transiteId(s, symbol);
+                if (!targets.empty()) {
+                    column[s + 1] = targets[0] + 1;
+                }
+            }
+
+            auto inserted = classes.insert((uint8_t) (columns.size() - 1));
+            if (!inserted.second) {
+                columns.pop_back();
+            }
+            uint8_t symbol_class = *inserted.first;
+            this->symbol_classes[symbol] = symbol_class;
+            if (symbol_name.length() == 1) {
+                this->byte_classes[(unsigned char) symbol_name[0]] = symbol_class;
+            }
+        }
+        this->class_count = columns.size();
+        // States are premultiplied by the number of classes, so every row must have a 32-bit ID
+        if ((uint64_t) this->state_count * this->class_count > UINT32_MAX) {
+            throw std::length_error("The DFA has too many states to be compiled.");
+        }
+
+        // Filling the table
+        std::shared_ptr<tables> built = std::make_shared<tables>();
+        built->table = std::vector<uint32_t>(this->state_count * this->class_count, 0);
+        for (uint32_t s = 0; s < this->state_count; s++) {
+            for (uint32_t c = 0; c < this->class_count; c++) {
+                built->table[s * this->class_count + c] = columns[c][s] * this->class_count;
+            }
+        }
+
+        // Accept bitmap
+        built->accepting = std::vector<uint64_t>(this->state_count / 64 + 1, 0);
+        for (stateId s = 0; s < dfa.getStateCount(); s++) {
+            if (dfa.isFinalStateId(s)) {
+                built->accepting[(s + 1) / 64] |= ((uint64_t) 1) << ((s + 1) % 64);
+            }
+        }
+
+        // Patterns of multi-pattern automatons
+        built->accept_offsets = std::vector<uint32_t>(this->state_count + 1, 0);
+        for (stateId s = 0; s < dfa.getStateCount(); s++) {
+            const patternList& patterns = dfa.getAcceptIds(s);
+            built->accept_pool.insert(built->accept_pool.end(), patterns.begin(), patterns.end());
+            built->accept_offsets[s + 2] = built->accept_pool.size();
+        }
+        this->setTables(built);
+
+        stateId initial_state = dfa.getInitialStateId();
+        this->initial_state = initial_state == NO_STATE ? 0 : (initial_state + 1) * this->class_count;
+    }
+
+    // CompiledDfa Information
+    /**
+     * @brief Gets the number of states of the table, the dead state included
+     * 
+     * @return The number of states
+     */
+    uint32_t getStateCount() const {
+        return this->state_count;
+    }
+
+    /**
+     * @brief Gets the number of symbol classes of the table, the class of the bytes that are
+     * not in the alphabet included
+     * 
+     * @return The number of symbol classes
+     */
+    uint32_t getClassCount() const {
+        return this->class_count;
+    }
+
+    // Stepping
+    /**
+     * @brief Gets the initial state of the table
+     * 
+     * @return The initial state, as a row offset
+     */
+    uint32_t getInitialState() const {
+        return this->initial_state;
+    }
+
+    /**
+     * @brief Gets the next state of the table
+     * 
+     * @param s The current state, as a row offset
+     * @param byte The byte read
+     * @return The next state, as a row offset
+     */
+    uint32_t next(uint32_t s, unsigned char byte) const {
+        return this->table[s + this->byte_classes[byte]];
+    }
+
+    /**
+     * @brief Gets the symbol class of a byte
+     * 
+     * @param byte The byte
+     * @return The class. 0 if the byte is not in the alphabet
+     */
+    uint8_t getByteClass(unsigned char byte) const {
+        return this->byte_classes[byte];
+    }
+
+    /**
+     * @brief Gets the next state of the table reading a symbol class
+     * 
+     * @param s The current state, as a row offset
+     * @param c The class read
+     * @return The next state, as a row offset
+     */
+    uint32_t nextByClass(uint32_t s, uint32_t c) const {
+        return this->table[s + c];
+    }
+
+    /**
+     * @brief Checks if a state of the table is accepting
+     * 
+     * @param s The state, as a row offset
+     * @return true if the state is accepting. false otherwise
+     */
+    bool isAccepting(uint32_t s) const {
+        s /= this->class_count;
+        return (this->accepting[s / 64] >> (s % 64)) & 1;
+    }
+
+    /**
+     * @brief Gets the patterns accepted by a state of the table, in multi-pattern automatons
+     * 
+     * @param s The state, as a row offset
+     * @return The sorted IDs of the patterns
+     */
+    patternSpan getAcceptIds(uint32_t s) const {
+        s /= this->class_count;
+        return patternSpan(this->accept_pool + this->accept_offsets[s], this->accept_pool + this->accept_offsets[s + 1]);
+    }
+
+    /**
+     * @brief Checks if a state of the table is the dead state. Once there, no sentence is
+     * accepted anymore, as long as the DFA has no other state that can not reach a final state
+     * 
+     * @param s The state, as a row offset
+     * @return true if the state is the dead state. false otherwise
+     */
+    bool isDead(uint32_t s) const {
+        return s == 0;
+    }
+
+    // Matching
+    /**
+     * @brief Tests if a sentence is accepted by the DFA
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool matches(const char* sentence, size_t length) const {
+        const uint32_t* table = this->table;
+        const uint8_t* byte_classes = this->byte_classes.data();
+        const unsigned char* input = (const unsigned char*) sentence;
+        uint32_t s = this->initial_state;
+        for (size_t i = 0; i < length; i++) {
+            s = table[s + byte_classes[input[i]]];
+        }
+        s /= this->class_count;
+        return (this->accepting[s / 64] >> (s % 64)) & 1;
+    }
+
+    /**
+     * @brief Tests if a sentence, already split into symbols, is accepted by the DFA
+     * 
+     * @param symbols The IDs of the symbols of the sentence, as in the compiled DFA
+     * @param length The number of symbols
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool matchesSymbols(const symbolId* symbols, size_t length) const {
+        const uint32_t* table = this->table;
+        uint32_t s = this->initial_state;
+        for (size_t i = 0; i < length; i++) {
+            if (symbols[i] >= this->symbol_classes.size()) {
+                return false;
+            }
+            s = table[s + this->symbol_classes[symbols[i]]];
+        }
+        s /= this->class_count;
+        return (this->accepting[s / 64] >> (s % 64)) & 1;
+    }
+
+    /**
+     * @brief Finds all the patterns of a multi-pattern automaton that accept a sentence, in a
+     * single pass over it
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @return The sorted IDs of the patterns that accept the sentence
+     */
+    patternSpan matchPatterns(const char* sentence, size_t length) const {
+        const uint32_t* table = this->table;
+        const uint8_t* byte_classes = this->byte_classes.data();
+        const unsigned char* input = (const unsigned char*) sentence;
+        uint32_t s = this->initial_state;
+        for (size_t i = 0; i < length; i++) {
+            s = table[s + byte_classes[input[i]]];
+        }
+        return this->getAcceptIds(s);
+    }
+
+    /**
+     * @brief Tests if a sentence is accepted by the DFA
+     * 
+     * @param sentence The sentence to be tested
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool testSentence(const std::string& sentence) const {
+        return this->matches(sentence.data(), sentence.length());
+    }
+
+    // Binary files
+    /**
+     * @brief Saves the CompiledDfa to a binary file, that can be mapped back with loadFromFile
+     * 
+     * @param file_path The file's path
+     * @param metadata Bytes stored after the arrays, given back by loadFromFile
+     * @throws std::runtime_error If the file can not be written
+     */
+    void saveToFile(const std::string& file_path, const std::string& metadata = "") const {
+        if (metadata.size() > UINT32_MAX) {
+            throw std::runtime_error("Metadata too large for file " + file_path + ".");
+        }
+        compiledDfaFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, COMPILED_DFA_MAGIC, sizeof(header.magic));
+        header.version = COMPILED_DFA_VERSION;
+        header.byte_order = COMPILED_DFA_BYTE_ORDER;
+        header.state_count = this->state_count;
+        header.class_count = this->class_count;
+        header.initial_state = this->initial_state;
+        header.symbol_count = this->symbol_classes.size();
+        header.accept_pool_size = this->accept_pool_size;
+        header.metadata_size = metadata.size();
+        memcpy(header.byte_classes, this->byte_classes.data(), sizeof(header.byte_classes));
+
+        uint64_t offsets[6];
+        uint64_t sizes[5];
+        getFileLayout(header, offsets, sizes);
+        const char* arrays[5] = {
+            (const char*) this->symbol_classes.data(),
+            (const char*) this->table,
+            (const char*) this->accepting,
+            (const char*) this->accept_offsets,
+            (const char*) this->accept_pool
+        };
+
+        std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not create file " + file_path + ".");
+        }
+        file.write((const char*) &header, sizeof(header));
+        const char padding[8] = {0};
+        uint64_t position = sizeof(header);
+        for (size_t i = 0; i < 5; i++) {
+            file.write(padding, offsets[i] - position);
+            file.write(arrays[i], sizes[i]);
+            position = offsets[i] + sizes[i];
+        }
+        file.write(padding, offsets[5] - position);
+        file.write(metadata.data(), metadata.size());
+        if (!file) {
+            throw std::runtime_error("Could not write file " + file_path + ".");
+        }
+    }
+
+    /**
+     * @brief Loads a CompiledDfa from a binary file saved with saveToFile. The file is mapped
+     * read-only and its arrays are used in place, so nothing is parsed or copied but the header
+     * 
+     * @param file_path The file's path
+     * @param verify If the transitions and the patterns are checked to be in range. Only files
+     * known to be written by saveToFile should skip it
+     * @param metadata Where the metadata saved with the file is written. Ignored if nullptr
+     * @return The CompiledDfa, which keeps the file mapped while it or any copy is alive
+     * @throws std::runtime_error If the file can not be read or is not a valid compiled DFA
+     */
+    static CompiledDfa loadFromFile(const std::string& file_path, bool verify = true, std::string* metadata = nullptr) {
+        std::shared_ptr<const MappedFile> file = std::make_shared<const MappedFile>(file_path, false);
+        const char* data = file->data();
+        if (file->size() < sizeof(compiledDfaFileHeader) || ((uintptr_t) data) % 8 != 0) {
+            throw std::runtime_error("Not a compiled DFA file.");
+        }
+
+        compiledDfaFileHeader header;
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, COMPILED_DFA_MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("Not a compiled DFA file.");
+        }
+        if (header.version != COMPILED_DFA_VERSION) {
+            throw std::runtime_error("Unsupported compiled DFA version " + std::to_string(header.version) + ".");
+        }
+        if (header.byte_order != COMPILED_DFA_BYTE_ORDER) {
+            throw std::runtime_error("The compiled DFA was saved with another byte order.");
+        }
+        if (header.state_count == 0 || header.class_count == 0 || header.class_count > 256 || header.symbol_count > NO_SYMBOL) {
+            throw std::runtime_error("Corrupted compiled DFA file.");
+        }
+        uint64_t offsets[6];
+        uint64_t sizes[5];
+        getFileLayout(header, offsets, sizes);
+        uint64_t row_count = (uint64_t) header.state_count * header.class_count;
+        if (row_count > UINT32_MAX || offsets[5] + header.metadata_size != file->size()) {
+            throw std::runtime_error("Corrupted compiled DFA file.");
+        }
+
+        CompiledDfa dfa = CompiledDfa();
+        dfa.state_count = header.state_count;
+        dfa.class_count = header.class_count;
+        dfa.initial_state = header.initial_state;
+        memcpy(dfa.byte_classes.data(), header.byte_classes, sizeof(header.byte_classes));
+        dfa.symbol_classes = std::vector<uint8_t>(data + offsets[0], data + offsets[0] + header.symbol_count);
+        dfa.table = (const uint32_t*) (data + offsets[1]);
+        dfa.accepting = (const uint64_t*) (data + offsets[2]);
+        dfa.accept_offsets = (const uint32_t*) (data + offsets[3]);
+        dfa.accept_pool = (const patternId*) (data + offsets[4]);
+        dfa.accept_pool_size = header.accept_pool_size;
+        dfa.storage = file;
+
+        // Anything out of range would be read out of the file
+        bool valid = dfa.initial_state < row_count && dfa.initial_state % dfa.class_count == 0;
+        for (size_t byte = 0; byte < 256; byte++) {
+            valid = valid && dfa.byte_classes[byte] < dfa.class_count;
+        }
+        for (uint8_t c : dfa.symbol_classes) {
+            valid = valid && c < dfa.class_count;
+        }
+        if (verify) {
+            uint32_t invalid = 0;
+            for (uint64_t i = 0; i < row_count; i++) {
+                uint32_t next = dfa.table[i];
+                invalid |= (next >= row_count) | (next % dfa.class_count != 0);
+            }
+            valid = valid && invalid == 0;
+            for (uint32_t s = 0; s < dfa.state_count; s++) {
+                valid = valid && dfa.accept_offsets[s] <= dfa.accept_offsets[s + 1];
+            }
+            valid = valid && dfa.accept_offsets[dfa.state_count] <= dfa.accept_pool_size;
+        }
+        if (!valid) {
+            throw std::runtime_error("Corrupted compiled DFA file.");
+        }
+        if (metadata != nullptr) {
+            metadata->assign(data + offsets[5], header.metadata_size);
+        }
+        return dfa;
+    }
+};
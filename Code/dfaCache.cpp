@@ -0,0 +1,232 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "fa.cpp"
+#include "algorithms.cpp"
+#include "compiledDfa.cpp"
+
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <direct.h>
+#include <process.h>
+#endif
+
+// Version of the compilation of REs. Increased whenever it changes the DFAs it builds, so the
+// entries cached by older versions are never read again
+const uint32_t DFA_CACHE_VERSION = 1;
+
+/**
+ * @brief A directory of compiled DFAs, addressed by the hash of the REs they were compiled
+ * from. Compiling a RE (Thompson's construction, λ removal, determinization and minimization)
+ * is done once, and later runs map the saved CompiledDfa back, which costs no parsing.
+ * 
+ * The key of an entry is the RE, already treated by treatExpression, together with the
+ * compilation options, DFA_CACHE_VERSION and COMPILED_DFA_VERSION, so a change of any of them
+ * leads to another file. The key is saved whole as the metadata of the entry's file and compared
+ * on load, so REs whose hashes collide are told apart and take turns in the entry instead of
+ * getting each other's DFA. Entries are written to a temporary file and renamed over the final
+ * one, so concurrent processes never see a partial entry and the last writer wins with an
+ * identical file. Unreadable, corrupted or colliding entries are compiled again and replaced.
+ */
+class DfaCache {
+private:
+    std::string directory;
+
+    /**
+     * @brief Hashes a string with 64-bit FNV-1a
+     * 
+     * @param text The string
+     * @return The hash
+     */
+    static uint64_t hashKey(const std::string& text) {
+        uint64_t hash = 0xcbf29ce484222325;
+        for (char c : text) {
+            hash ^= (unsigned char) c;
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Gets the path of the entry of a RE
+     * 
+     * @param expression The RE
+     * @param minimize If the DFA is minimized
+     * @return The path of the entry
+     */
+    std::string getEntryPath(const std::string& expression, bool minimize) const {
+        char name[17];
+        snprintf(name, sizeof(name), "%016llx", (unsigned long long) hashKey(getKey(expression, minimize)));
+        return this->directory + name + ".dfa";
+    }
+
+    /**
+     * @brief Gets a name for a temporary file, unique among the processes and threads that
+     * write to the cache
+     * 
+     * @param entry_path The path of the entry the file will be renamed to
+     * @return The temporary file's path
+     */
+    static std::string getTemporaryPath(const std::string& entry_path) {
+        static std::atomic<uint32_t> counter(0);
+#ifndef _WIN32
+        long process = getpid();
+#else
+        long process = _getpid();
+#endif
+        long long ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+        return entry_path + ".tmp." + std::to_string(process) + "." + std::to_string(counter++) + "." + std::to_string(ticks);
+    }
+
+    /**
+     * @brief Compiles a RE into a DFA
+     * 
+     * @param expression The RE
+     * @param minimize If the DFA is minimized
+     * @return The compiled DFA
+     * @throws std::invalid_argument If the RE is invalid
+     */
+    static CompiledDfa compileExpression(const std::string& expression, bool minimize) {
+        FA fa = getFAFromRE(expression);
+        if (fa.getStateCount() == 0) {
+            throw std::invalid_argument("Invalid regular expression.");
+        }
+        FA dfa = determinizeFA(removeLambdaTransitions(fa));
+        dfa.removeUnreachableStates();
+        if (minimize) {
+            dfa = automatonMinimizationAlgorithm(dfa, false);
+        }
+        return CompiledDfa(dfa);
+    }
+
+public:
+    // Constructors
+    DfaCache() {
+        this->directory = "";
+    }
+
+    /**
+     * @brief Opens a cache directory. It is created when the first entry is stored
+     * 
+     * @param directory The directory's path, ending with a separator
+     */
+    DfaCache(const std::string& directory) : DfaCache() {
+        this->directory = directory;
+    }
+
+    // DfaCache Information
+    /**
+     * @brief Gets the key of the entry of a RE, whose hash names the entry and which is saved
+     * in it
+     * 
+     * @param expression The RE, already treated by treatExpression
+     * @param minimize If the DFA is minimized
+     * @return The key
+     */
+    static std::string getKey(const std::string& expression, bool minimize) {
+        return "v" + std::to_string(DFA_CACHE_VERSION) + "." + std::to_string(COMPILED_DFA_VERSION) + (minimize ? " minimized " : " ") + expression;
+    }
+
+    // Caching
+    /**
+     * @brief Loads the cached DFA of a RE. An entry saved for another key with the same hash
+     * is a miss
+     * 
+     * @param expression The RE, already treated by treatExpression
+     * @param minimize If the DFA is minimized
+     * @param dfa Where the DFA is loaded to
+     * @return true if the RE was cached. false otherwise
+     */
+    bool load(const std::string& expression, bool minimize, CompiledDfa& dfa) const {
+        std::string entry_path = this->getEntryPath(expression, minimize);
+        if (!existsFile(entry_path)) {
+            return false;
+        }
+        std::string key;
+        CompiledDfa loaded;
+        try {
+            loaded = CompiledDfa::loadFromFile(entry_path, true, &key);
+        } catch (const std::runtime_error& e) {
+            return false;
+        }
+        if (key != getKey(expression, minimize)) {
+            return false;
+        }
+        dfa = loaded;
+        return true;
+    }
+
+    /**
+     * @brief Stores the DFA of a RE, replacing the entry the RE had
+     * 
+     * @param expression The RE, already treated by treatExpression
+     * @param minimize If the DFA is minimized
+     * @param dfa The DFA
+     * @throws std::runtime_error If the entry can not be written
+     */
+    void store(const std::string& expression, bool minimize, const CompiledDfa& dfa) const {
+        if (!this->directory.empty() && !existsFile(this->directory)) {
+#ifndef _WIN32
+            mkdir(this->directory.c_str(), 0755);
+#else
+            _mkdir(this->directory.c_str());
+#endif
+        }
+        std::string entry_path = this->getEntryPath(expression, minimize);
+        std::string temporary_path = getTemporaryPath(entry_path);
+        try {
+            dfa.saveToFile(temporary_path, getKey(expression, minimize));
+        } catch (const std::runtime_error& e) {
+            std::remove(temporary_path.c_str());
+            throw;
+        }
+#ifdef _WIN32
+        // rename does not replace existing files on Windows
+        std::remove(entry_path.c_str());
+#endif
+        if (std::rename(temporary_path.c_str(), entry_path.c_str()) != 0) {
+            std::remove(temporary_path.c_str());
+            throw std::runtime_error("Could not write file " + entry_path + ".");
+        }
+    }
+
+    /**
+     * @brief Gets the DFA of a RE from the cache, compiling and storing it if it is not there.
+     * A cache that can not be written does not stop the compilation
+     * 
+     * @param expression The RE, already treated by treatExpression
+     * @param minimize If the DFA is minimized
+     * @param hit Where it is written if the DFA came from the cache. Ignored if nullptr
+     * @return The compiled DFA
+     * @throws std::invalid_argument If the RE is invalid
+     */
+    CompiledDfa compile(const std::string& expression, bool minimize = true, bool* hit = nullptr) const {
+        CompiledDfa dfa;
+        bool cached = this->load(expression, minimize, dfa);
+        if (hit != nullptr) {
+            *hit = cached;
+        }
+        if (cached) {
+            return dfa;
+        }
+        dfa = compileExpression(expression, minimize);
+        try {
+            this->store(expression, minimize, dfa);
+        } catch (const std::runtime_error& e) {
+            // The DFA is still usable, it is only compiled again next time
+        }
+        return dfa;
+    }
+};
@@ -3,9 +3,17 @@
  * @author Felipe Nepomuceno Coelho (689661)
  */
 
+#pragma once
+
 #include <set>
 #include <map>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
 #include <utility>
+#include <cstdint>
+#include <stdexcept>
 #include <iostream>
 #include "utils.cpp"
 #include "string.h"
@@ -13,53 +21,733 @@
 typedef std::string state;
 typedef std::pair<state, std::string> transition;
 
+typedef uint32_t stateId;
+typedef uint8_t symbolId;
+typedef std::vector<stateId> stateList;
+// Patterns of a multi-pattern automaton, accepted by its final states
+typedef uint32_t patternId;
+typedef std::vector<patternId> patternList;
+
+/**
+ * @brief A read-only view of a contiguous sequence of IDs, that can be iterated without
+ * copying them
+ */
+template <typename T>
+struct idSpan {
+    const T* first;
+    const T* last;
+
+    idSpan(const T* first, const T* last) : first(first), last(last) {}
+
+    const T* begin() const { return this->first; }
+    const T* end() const { return this->last; }
+    size_t size() const { return this->last - this->first; }
+    bool empty() const { return this->first == this->last; }
+    T operator[](size_t i) const { return this->first[i]; }
+};
+
+typedef idSpan<stateId> stateSpan;
+typedef idSpan<patternId> patternSpan;
+
+// Sentinel values for the interned representation
+const stateId NO_STATE = UINT32_MAX;
+const symbolId NO_SYMBOL = UINT8_MAX;
+// The λ symbol is always interned as the first symbol
+const symbolId LAMBDA = 0;
+
+/**
+ * @brief A transition of a FA, with states and symbol as IDs
+ */
+struct transitionId {
+    stateId from;
+    symbolId read;
+    stateId to;
+};
+
+/**
+ * @brief A read-only view of all the transitions of a FA, iterated in order of state, symbol
+ * and target without building any container
+ */
+class transitionView {
+private:
+    const std::vector<std::vector<stateList>>* transitions;
+
+public:
+    class iterator {
+    private:
+        const std::vector<std::vector<stateList>>* transitions;
+        stateId from;
+        size_t read;
+        size_t index;
+
+        // Moves forward until a transition is found, or to the end
+        void skipEmpty() {
+            while (this->from < this->transitions->size()) {
+                const std::vector<stateList>& row = (*this->transitions)[this->from];
+                while (this->read < row.size()) {
+                    if (this->index < row[this->read].size()) return;
+                    this->read++;
+                    this->index = 0;
+                }
+                this->from++;
+                this->read = 0;
+                this->index = 0;
+            }
+        }
+
+    public:
+        iterator(const std::vector<std::vector<stateList>>* transitions, stateId from)
+            : transitions(transitions), from(from), read(0), index(0) {
+            this->skipEmpty();
+        }
+
+        transitionId operator*() const {
+            return {this->from, (symbolId) this->read, (*this->transitions)[this->from][this->read][this->index]};
+        }
+
+        iterator& operator++() {
+            this->index++;
+            this->skipEmpty();
+            return *this;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return this->from != other.from || this->read != other.read || this->index != other.index;
+        }
+    };
+
+    transitionView(const std::vector<std::vector<stateList>>* transitions) : transitions(transitions) {}
+
+    iterator begin() const { return iterator(this->transitions, 0); }
+    iterator end() const { return iterator(this->transitions, this->transitions->size()); }
+};
+
+/**
+ * @brief Splits sentences into the symbols of an alphabet whose symbols may have more than one
+ * character. The symbols are compiled into a trie of their characters and every token is the
+ * longest symbol that starts at the current position, so each character is read a bounded
+ * number of times instead of trying every prefix against the alphabet.
+ * 
+ * When all the symbols have a single character, tokenizing is a single table load per byte.
+ */
+class SymbolTokenizer {
+private:
+    // children[row * 256 + byte] is the child of the node whose row is row. 0 if there is none,
+    // since the root is never a child
+    std::vector<uint32_t> children;
+    // rows[node] is the row of the node in children. NO_STATE for nodes without children
+    std::vector<uint32_t> rows;
+    // node_symbols[node] is the symbol spelled by the path to the node. NO_SYMBOL if none
+    std::vector<symbolId> node_symbols;
+    // byte_symbols[byte] is the single-character symbol of the byte. NO_SYMBOL if none
+    std::array<symbolId, 256> byte_symbols;
+    bool multi_char;
+
+public:
+    // Constructors
+    SymbolTokenizer() {
+        this->children = std::vector<uint32_t>(256, 0);
+        this->rows = std::vector<uint32_t>(1, 0);
+        this->node_symbols = std::vector<symbolId>(1, NO_SYMBOL);
+        this->byte_symbols.fill(NO_SYMBOL);
+        this->multi_char = false;
+    }
+
+    /**
+     * @brief Compiles an alphabet into a trie
+     * 
+     * @param symbol_names The names of the symbols, indexed by ID. The λ symbol is left out
+     */
+    SymbolTokenizer(const std::vector<std::string>& symbol_names) : SymbolTokenizer() {
+        for (size_t symbol = 1; symbol < symbol_names.size(); symbol++) {
+            this->addSymbol(symbol_names[symbol], symbol);
+        }
+    }
+
+    // Building
+    /**
+     * @brief Adds a symbol to the trie. Empty symbols are ignored
+     * 
+     * @param symbol The symbol's name
+     * @param id The symbol's ID
+     */
+    void addSymbol(const std::string& symbol, symbolId id) {
+        if (symbol.empty()) {
+            return;
+        }
+        if (symbol.length() == 1) {
+            this->byte_symbols[(unsigned char) symbol[0]] = id;
+        } else {
+            this->multi_char = true;
+        }
+        uint32_t node = 0;
+        for (char c : symbol) {
+            if (this->rows[node] == NO_STATE) {
+                this->rows[node] = this->children.size() / 256;
+                this->children.resize(this->children.size() + 256, 0);
+            }
+            uint32_t& child = this->children[this->rows[node] * 256 + (unsigned char) c];
+            if (child == 0) {
+                child = this->rows.size();
+                this->rows.push_back(NO_STATE);
+                this->node_symbols.push_back(NO_SYMBOL);
+            }
+            node = child;
+        }
+        this->node_symbols[node] = id;
+    }
+
+    // SymbolTokenizer Information
+    /**
+     * @brief Checks if the alphabet has symbols with more than one character
+     * 
+     * @return true if there is some multi-character symbol. false otherwise
+     */
+    bool hasMultiCharSymbols() const {
+        return this->multi_char;
+    }
+
+    // Tokenizing
+    /**
+     * @brief Splits a sentence into symbols, taking the longest symbol at each position
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @param symbols The list the IDs of the symbols are appended to
+     * @return true if the whole sentence was split. false if some position does not start any
+     * symbol
+     */
+    bool tokenize(const char* sentence, size_t length, std::vector<symbolId>& symbols) const {
+        const unsigned char* input = (const unsigned char*) sentence;
+        const uint32_t* children = this->children.data();
+        const symbolId* node_symbols = this->node_symbols.data();
+        symbols.reserve(symbols.size() + length);
+
+        if (!this->multi_char) {
+            for (size_t i = 0; i < length; i++) {
+                symbolId symbol = this->byte_symbols[input[i]];
+                if (symbol == NO_SYMBOL) {
+                    return false;
+                }
+                symbols.push_back(symbol);
+            }
+            return true;
+        }
+
+        size_t i = 0;
+        while (i < length) {
+            symbolId longest = NO_SYMBOL;
+            size_t longest_end = i;
+            uint32_t node = 0;
+            for (size_t j = i; j < length && this->rows[node] != NO_STATE; j++) {
+                node = children[this->rows[node] * 256 + input[j]];
+                if (node == 0) break;
+                if (node_symbols[node] != NO_SYMBOL) {
+                    longest = node_symbols[node];
+                    longest_end = j + 1;
+                }
+            }
+            if (longest == NO_SYMBOL) {
+                return false;
+            }
+            symbols.push_back(longest);
+            i = longest_end;
+        }
+        return true;
+    }
+};
+
 /**
- * @brief A class representing a Finite Automaton
+ * @brief A class representing a Finite Automaton. States and symbols are interned as dense
+ * integer IDs, and their names are only kept in side tables, so the string based methods
+ * are just a translation layer for the JFF files and the user interface.
+ * 
+ * All the const methods are free of side effects (lookups never insert anything and scratch
+ * memory is local to each call), so a FA that is no longer modified can be queried by many
+ * threads at the same time.
  */
 class FA {
 private:
-    std::set<state> states;
-    std::set<std::string> alphabet;
-    std::map<transition, std::set<state>> transitions;
-    state initial_state;
-    std::set<state> final_states;
+    // States side table
+    std::vector<std::string> state_names;
+    std::unordered_map<std::string, stateId> state_ids;
+
+    // Symbols side table
+    std::vector<std::string> symbol_names;
+    std::unordered_map<std::string, symbolId> symbol_ids;
+    std::vector<bool> alphabet;
+    // Splits sentences into the interned symbols. Kept up to date by internSymbol
+    SymbolTokenizer tokenizer;
+
+    // transitions[from][symbol] is the sorted list of states reached from "from" by "symbol"
+    std::vector<std::vector<stateList>> transitions;
+    size_t lambda_transitions;
+
+    stateId initial_state;
+    std::vector<bool> final_states;
+    // accept_ids[s] is the sorted list of the patterns accepted by the final state s, in
+    // multi-pattern automatons. Empty for the other automatons
+    std::vector<patternList> accept_ids;
+
+    /**
+     * @brief Keeps only the states marked in a mask, compacting their IDs. Transitions from or
+     * to removed states are dropped
+     * 
+     * @param keep A mask indexed by state ID with the states to be kept
+     */
+    void keepStates(std::vector<bool> keep) {
+        std::vector<stateId> new_ids(this->state_names.size(), NO_STATE);
+        stateId next_id = 0;
+        for (stateId s = 0; s < this->state_names.size(); s++) {
+            if (keep[s]) {
+                new_ids[s] = next_id++;
+            }
+        }
+
+        std::vector<std::string> new_names(next_id);
+        std::vector<std::vector<stateList>> new_transitions(next_id);
+        std::vector<bool> new_final_states(next_id, false);
+        std::vector<patternList> new_accept_ids(next_id);
+        this->state_ids.clear();
+        this->lambda_transitions = 0;
+        for (stateId s = 0; s < this->state_names.size(); s++) {
+            if (new_ids[s] == NO_STATE) continue;
+            stateId id = new_ids[s];
+            new_names[id] = this->state_names[s];
+            new_final_states[id] = this->final_states[s];
+            new_accept_ids[id] = this->accept_ids[s];
+            this->state_ids[new_names[id]] = id;
+            new_transitions[id].resize(this->transitions[s].size());
+            for (size_t symbol = 0; symbol < this->transitions[s].size(); symbol++) {
+                for (stateId to : this->transitions[s][symbol]) {
+                    if (new_ids[to] != NO_STATE) {
+                        new_transitions[id][symbol].push_back(new_ids[to]);
+                    }
+                }
+                if (symbol == LAMBDA) {
+                    this->lambda_transitions += new_transitions[id][symbol].size();
+                }
+            }
+        }
+
+        if (this->initial_state != NO_STATE) {
+            this->initial_state = new_ids[this->initial_state];
+        }
+        this->state_names = new_names;
+        this->transitions = new_transitions;
+        this->final_states = new_final_states;
+        this->accept_ids = new_accept_ids;
+    }
+
+    /**
+     * @brief Adds the states reachable by lambda transitions from the states of a list to it.
+     * A state is in the list if its mark is equal to the generation
+     * 
+     * @param states The list of states to be closed
+     * @param marks The marks of all the states of the FA
+     * @param generation The mark of the states that are in the list
+     */
+    void closeByLambda(stateList& states, std::vector<uint32_t>& marks, uint32_t generation) const {
+        for (size_t i = 0; i < states.size(); i++) {
+            for (stateId next_state : this->transiteId(states[i], LAMBDA)) {
+                if (marks[next_state] != generation) {
+                    marks[next_state] = generation;
+                    states.push_back(next_state);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the IDs of all the states, sorted by their names
+     * 
+     * @return The IDs of the states
+     */
+    stateList getStatesByName() const {
+        stateList states(this->state_names.size());
+        for (stateId s = 0; s < states.size(); s++) {
+            states[s] = s;
+        }
+        std::sort(states.begin(), states.end(), [this](stateId a, stateId b) {
+            return this->state_names[a] < this->state_names[b];
+        });
+        return states;
+    }
 
 public:
     // Constructors
     FA() {
-        this->states = std::set<state>();
-        this->alphabet = std::set<std::string>();
-        this->transitions = std::map<transition, std::set<state>>();
-        this->initial_state = "";
-        this->final_states = std::set<state>();
+        this->state_names = std::vector<std::string>();
+        this->state_ids = std::unordered_map<std::string, stateId>();
+        this->symbol_names = std::vector<std::string>();
+        this->symbol_ids = std::unordered_map<std::string, symbolId>();
+        this->alphabet = std::vector<bool>();
+        this->tokenizer = SymbolTokenizer();
+        this->transitions = std::vector<std::vector<stateList>>();
+        this->lambda_transitions = 0;
+        this->initial_state = NO_STATE;
+        this->final_states = std::vector<bool>();
+        this->accept_ids = std::vector<patternList>();
+        this->internSymbol("&");
     }
 
     FA(std::set<state> states,
         std::set<std::string> alphabet,
         std::map<transition, std::set<state>> transitions,
         state initial_state,
-        std::set<state> final_states) {
-        this->states = states;
-        this->alphabet = alphabet;
-        this->transitions = transitions;
-        this->initial_state = initial_state;
-        this->final_states = final_states;
+        std::set<state> final_states) : FA() {
+        for (state s : states) {
+            this->addState(s);
+        }
+        for (std::string symbol : alphabet) {
+            this->addSymbol(symbol);
+        }
+        for (auto const& aTransition : transitions) {
+            for (state to : aTransition.second) {
+                this->addTransition(aTransition.first.first, aTransition.first.second, to);
+            }
+        }
+        this->setInitialState(initial_state);
+        for (state s : final_states) {
+            this->addFinalState(s);
+        }
     }
 
-    // FA Creation
+    // Interned representation
     /**
-     * @brief Adds a state to the FA
+     * @brief Gets the ID of a state, adding it to the FA if it does not exist yet
      * 
-     * @param s The state to be added
+     * @param s The state's name
+     * @return The state's ID. NO_STATE if the name is empty
      */
-    void addState(state s) {
+    stateId internState(const state& s) {
         if (s.length() == 0) {
-            return;
+            return NO_STATE;
+        }
+        auto it = this->state_ids.find(s);
+        if (it != this->state_ids.end()) {
+            return it->second;
+        }
+        stateId id = this->state_names.size();
+        this->state_names.push_back(s);
+        this->state_ids[s] = id;
+        this->transitions.push_back(std::vector<stateList>());
+        this->final_states.push_back(false);
+        this->accept_ids.push_back(patternList());
+        return id;
+    }
+
+    /**
+     * @brief Adds a new state to the FA, named after its ID
+     * 
+     * @return The new state's ID
+     */
+    stateId newState() {
+        std::string name = std::to_string(this->state_names.size());
+        while (this->state_ids.find(name) != this->state_ids.end()) {
+            name += "'";
+        }
+        return this->internState(name);
+    }
+
+    /**
+     * @brief Gets the ID of a symbol, interning it if it does not exist yet. The symbol is not
+     * added to the FA's alphabet
+     * 
+     * @param symbol The symbol
+     * @return The symbol's ID
+     */
+    symbolId internSymbol(const std::string& symbol) {
+        auto it = this->symbol_ids.find(symbol);
+        if (it != this->symbol_ids.end()) {
+            return it->second;
         }
-        if (has(this->getStates(),s)) {
+        if (this->symbol_names.size() >= NO_SYMBOL) {
+            throw std::length_error("The FA can not have more than 254 symbols.");
+        }
+        symbolId id = this->symbol_names.size();
+        this->symbol_names.push_back(symbol);
+        this->symbol_ids[symbol] = id;
+        this->alphabet.push_back(false);
+        if (id != LAMBDA) {
+            this->tokenizer.addSymbol(symbol, id);
+        }
+        return id;
+    }
+
+    /**
+     * @brief Gets the ID of a state
+     * 
+     * @param s The state's name
+     * @return The state's ID. NO_STATE if the state does not exist
+     */
+    stateId getStateId(const state& s) const {
+        auto it = this->state_ids.find(s);
+        return it == this->state_ids.end() ? NO_STATE : it->second;
+    }
+
+    /**
+     * @brief Gets the ID of a symbol
+     * 
+     * @param symbol The symbol
+     * @return The symbol's ID. NO_SYMBOL if the symbol was never interned
+     */
+    symbolId getSymbolId(const std::string& symbol) const {
+        auto it = this->symbol_ids.find(symbol);
+        return it == this->symbol_ids.end() ? NO_SYMBOL : it->second;
+    }
+
+    /**
+     * @brief Gets the name of a state
+     * 
+     * @param s The state's ID
+     * @return The state's name
+     */
+    const state& getStateName(stateId s) const {
+        return this->state_names[s];
+    }
+
+    /**
+     * @brief Gets a symbol from its ID
+     * 
+     * @param symbol The symbol's ID
+     * @return The symbol
+     */
+    const std::string& getSymbolName(symbolId symbol) const {
+        return this->symbol_names[symbol];
+    }
+
+    /**
+     * @brief Gets the names of all the states, indexed by their IDs
+     * 
+     * @return A reference to the names of the states
+     */
+    const std::vector<std::string>& getStateNames() const {
+        return this->state_names;
+    }
+
+    /**
+     * @brief Gets all the transitions from a state, indexed by symbol ID. Symbols past the end
+     * of the row have no transitions
+     * 
+     * @param from The state's ID
+     * @return A reference to the lists of states reached by each symbol
+     */
+    const std::vector<stateList>& getTransitionRow(stateId from) const {
+        return this->transitions[from];
+    }
+
+    /**
+     * @brief Gets a view of all the transitions of the FA, that can be iterated without copying
+     * them
+     * 
+     * @return The view of the transitions
+     */
+    transitionView getTransitionView() const {
+        return transitionView(&this->transitions);
+    }
+
+    /**
+     * @brief Gets the number of states of the FA. State IDs go from 0 to this number - 1
+     * 
+     * @return The number of states
+     */
+    size_t getStateCount() const {
+        return this->state_names.size();
+    }
+
+    /**
+     * @brief Gets the number of interned symbols, λ included. Symbol IDs go from 0 to this
+     * number - 1
+     * 
+     * @return The number of interned symbols
+     */
+    size_t getSymbolCount() const {
+        return this->symbol_names.size();
+    }
+
+    /**
+     * @brief Checks if an interned symbol belongs to the FA's alphabet
+     * 
+     * @param symbol The symbol's ID
+     * @return true if the symbol is in the alphabet. false otherwise
+     */
+    bool isAlphabetSymbol(symbolId symbol) const {
+        return this->alphabet[symbol];
+    }
+
+    /**
+     * @brief Gets the ID of the FA's initial state
+     * 
+     * @return The initial state's ID. NO_STATE if there is no initial state
+     */
+    stateId getInitialStateId() const {
+        return this->initial_state;
+    }
+
+    /**
+     * @brief Checks if a state is a final state
+     * 
+     * @param s The state's ID
+     * @return true if the state is a final state. false otherwise
+     */
+    bool isFinalStateId(stateId s) const {
+        return this->final_states[s];
+    }
+
+    /**
+     * @brief Gets the states to which a transition goes when a symbol is read by a state
+     * 
+     * @param from The ID of the state from which the transition starts
+     * @param read The ID of the symbol that triggers the transition
+     * @return The sorted list of the IDs of the states to which the transition goes
+     */
+    const stateList& transiteId(stateId from, symbolId read) const {
+        static const stateList no_states = stateList();
+        if (read >= this->transitions[from].size()) {
+            return no_states;
+        }
+        return this->transitions[from][read];
+    }
+
+    /**
+     * @brief Adds a transition to the FA
+     * 
+     * @param from The ID of the state from which the transition starts
+     * @param read The ID of the symbol that triggers the transition
+     * @param to The ID of the state to which the transition goes
+     */
+    void addTransitionId(stateId from, symbolId read, stateId to) {
+        std::vector<stateList>& row = this->transitions[from];
+        if (read >= row.size()) {
+            row.resize(read + 1);
+        }
+        stateList& targets = row[read];
+        auto it = std::lower_bound(targets.begin(), targets.end(), to);
+        if (it != targets.end() && *it == to) {
             return;
         }
-        this->states.insert(s);
+        targets.insert(it, to);
+        if (read == LAMBDA) {
+            this->lambda_transitions++;
+        }
+    }
+
+    /**
+     * @brief Replaces all the transitions of a state by a symbol
+     * 
+     * @param from The ID of the state from which the transitions start
+     * @param read The ID of the symbol that triggers the transitions
+     * @param to The sorted list of the IDs of the states to which the transitions go, without
+     * repetitions
+     */
+    void setTransitionsId(stateId from, symbolId read, stateList to) {
+        std::vector<stateList>& row = this->transitions[from];
+        if (read >= row.size()) {
+            if (to.empty()) return;
+            row.resize(read + 1);
+        }
+        if (read == LAMBDA) {
+            this->lambda_transitions = this->lambda_transitions - row[read].size() + to.size();
+        }
+        row[read] = to;
+    }
+
+    /**
+     * @brief Removes all the transitions of the FA, keeping its states and alphabet
+     */
+    void clearTransitions() {
+        this->transitions.assign(this->state_names.size(), std::vector<stateList>());
+        this->lambda_transitions = 0;
+    }
+
+    /**
+     * @brief Sets the FA's initial state
+     * 
+     * @param s The ID of the state to be set as initial
+     */
+    void setInitialStateId(stateId s) {
+        this->initial_state = s;
+    }
+
+    /**
+     * @brief Sets whether a state is final. A state that stops being final stops accepting its
+     * patterns
+     * 
+     * @param s The state's ID
+     * @param is_final true to make the state final. false otherwise
+     */
+    void setFinalStateId(stateId s, bool is_final = true) {
+        this->final_states[s] = is_final;
+        if (!is_final) {
+            this->accept_ids[s].clear();
+        }
+    }
+
+    // Multi-pattern automatons
+    /**
+     * @brief Makes a state final for a pattern
+     * 
+     * @param s The state's ID
+     * @param pattern The pattern's ID
+     */
+    void addAcceptId(stateId s, patternId pattern) {
+        patternList& patterns = this->accept_ids[s];
+        auto it = std::lower_bound(patterns.begin(), patterns.end(), pattern);
+        if (it == patterns.end() || *it != pattern) {
+            patterns.insert(it, pattern);
+        }
+        this->final_states[s] = true;
+    }
+
+    /**
+     * @brief Gets the patterns accepted by a state
+     * 
+     * @param s The state's ID
+     * @return The sorted list of the patterns' IDs. Empty if the state is not final or the FA
+     * is not a multi-pattern automaton
+     */
+    const patternList& getAcceptIds(stateId s) const {
+        return this->accept_ids[s];
+    }
+
+    /**
+     * @brief Gets the number of patterns of the FA
+     * 
+     * @return The highest pattern ID plus one. 0 if the FA is not a multi-pattern automaton
+     */
+    size_t getPatternCount() const {
+        size_t pattern_count = 0;
+        for (const patternList& patterns : this->accept_ids) {
+            if (!patterns.empty()) {
+                pattern_count = std::max<size_t>(pattern_count, patterns.back() + 1);
+            }
+        }
+        return pattern_count;
+    }
+
+    // FA Creation
+    /**
+     * @brief Adds a state to the FA
+     * 
+     * @param s The state to be added
+     */
+    void addState(const state& s) {
+        this->internState(s);
+    }
+
+    /**
+     * @brief Allocates room for a number of states, so that adding them does not grow the
+     * tables of the FA again and again
+     * 
+     * @param state_count The number of states the FA will have
+     */
+    void reserveStates(size_t state_count) {
+        this->state_names.reserve(state_count);
+        this->state_ids.reserve(state_count);
+        this->transitions.reserve(state_count);
+        this->final_states.reserve(state_count);
+        this->accept_ids.reserve(state_count);
     }
 
     /**
@@ -67,7 +755,7 @@ public:
      * 
      * @param symbol The symbol to be added
      */
-    void addSymbol(std::string symbol) {
+    void addSymbol(const std::string& symbol) {
         if (symbol.length() == 0) {
             return;
         }
@@ -80,7 +768,7 @@ public:
                 return;
             }
         }
-        this->alphabet.insert(symbol);
+        this->alphabet[this->internSymbol(symbol)] = true;
     }
 
     /**
@@ -90,8 +778,13 @@ public:
      * @param read The symbol that triggers the transition
      * @param to The state to which the transition goes
      */
-    void addTransition(state from, std::string read, state to) {
-        this->transitions[std::make_pair(from, read)].insert(to);
+    void addTransition(const state& from, const std::string& read, const state& to) {
+        stateId from_id = this->internState(from);
+        stateId to_id = this->internState(to);
+        if (from_id == NO_STATE || to_id == NO_STATE) {
+            return;
+        }
+        this->addTransitionId(from_id, this->internSymbol(read), to_id);
     }
 
     /**
@@ -99,8 +792,8 @@ public:
      * 
      * @param s The state to be set as initial
      */
-    void setInitialState(state s) {
-        this->initial_state = s;
+    void setInitialState(const state& s) {
+        this->initial_state = this->internState(s);
     }
 
     /**
@@ -108,8 +801,11 @@ public:
      * 
      * @param s The state to be added as final
      */
-    void addFinalState(state s) {
-        this->final_states.insert(s);
+    void addFinalState(const state& s) {
+        stateId id = this->internState(s);
+        if (id != NO_STATE) {
+            this->final_states[id] = true;
+        }
     }
 
     // FA Information
@@ -119,8 +815,9 @@ public:
      * @param s The state to be checked
      * @return true if the state is a final state. false otherwise
      */
-    bool isFinalState(state s) {
-        return this->final_states.find(s) != this->final_states.end();
+    bool isFinalState(const state& s) const {
+        stateId id = this->getStateId(s);
+        return id != NO_STATE && this->final_states[id];
     }
 
     /**
@@ -128,29 +825,40 @@ public:
      * 
      * @return The FA's initial state
      */
-    state getInitialState() {
-        return this->initial_state;
+    state getInitialState() const {
+        if (this->initial_state == NO_STATE) {
+            return "";
+        }
+        return this->state_names[this->initial_state];
     }
 
     /**
-     * @brief Gets a set of the FA's final states
+     * @brief Gets a set of the FA's final states. A slow compatibility helper that copies the
+     * names into a new set on every call. Prefer isFinalStateId
      * 
      * @return The FA's final states
      */
-    std::set<state> getFinalStates() {
-        return this->final_states;
+    std::set<state> getFinalStates() const {
+        std::set<state> final_states;
+        for (stateId s = 0; s < this->state_names.size(); s++) {
+            if (this->final_states[s]) {
+                final_states.insert(this->state_names[s]);
+            }
+        }
+        return final_states;
     }
 
     /**
-     * @brief Gets a set of the FA's non-final states
+     * @brief Gets a set of the FA's non-final states. A slow compatibility helper that copies the
+     * names into a new set on every call. Prefer isFinalStateId
      * 
      * @return The FA's non-final states
      */
-    std::set<state> getNonFinalStates() {
+    std::set<state> getNonFinalStates() const {
         std::set<state> non_final_states;
-        for (state s : this->states) {
-            if (!this->isFinalState(s)) {
-                non_final_states.insert(s);
+        for (stateId s = 0; s < this->state_names.size(); s++) {
+            if (!this->final_states[s]) {
+                non_final_states.insert(this->state_names[s]);
             }
         }
         return non_final_states;
@@ -161,17 +869,18 @@ public:
      * 
      */
     void clearFinalStates() {
-        this->final_states.clear();
+        this->final_states.assign(this->state_names.size(), false);
+        this->accept_ids.assign(this->state_names.size(), patternList());
     }
 
     /**
      * @brief Prints the SuperFA's states to the console
      * 
      */
-    void printStates() {
+    void printStates() const {
         std::string text = "States: {";
-        for (state st : this->states) {
-            text += (st + ",");
+        for (stateId s : this->getStatesByName()) {
+            text += (this->state_names[s] + ",");
         }
         text.pop_back();
         text += "}";
@@ -185,35 +894,63 @@ public:
      * @param read The symbol that triggers the transition
      * @return The set of states to which the transition goes
      */
-    std::set<state> transite(state from, std::string read) {
-        return this->transitions[std::make_pair(from, read)];
+    std::set<state> transite(const state& from, const std::string& read) const {
+        std::set<state> states;
+        stateId from_id = this->getStateId(from);
+        symbolId symbol = this->getSymbolId(read);
+        if (from_id == NO_STATE || symbol == NO_SYMBOL) {
+            return states;
+        }
+        for (stateId to : this->transiteId(from_id, symbol)) {
+            states.insert(this->state_names[to]);
+        }
+        return states;
     }
 
     /**
-     * @brief Gets all the states of the FA
+     * @brief Gets all the states of the FA. A slow compatibility helper that copies the names
+     * into a new set on every call. Prefer getStateCount and getStateNames
      * 
      * @return A set of states that contains all the states of the FA
      */
-    std::set<state> getStates() {
-        return this->states;
+    std::set<state> getStates() const {
+        return std::set<state>(this->state_names.begin(), this->state_names.end());
     }
 
     /**
-     * @brief Gets all the transitions of the FA
+     * @brief Gets all the transitions of the FA. A slow compatibility helper that builds a new
+     * map of names on every call. Prefer getTransitionView and transiteId
      * 
      * @return A map that contains all the transitions of the FA
      */
-    std::map<transition, std::set<state>> getTransitions() {
-        return this->transitions;
+    std::map<transition, std::set<state>> getTransitions() const {
+        std::map<transition, std::set<state>> transitions;
+        for (stateId s = 0; s < this->state_names.size(); s++) {
+            for (size_t symbol = 0; symbol < this->transitions[s].size(); symbol++) {
+                if (this->transitions[s][symbol].empty()) continue;
+                std::set<state>& targets = transitions[std::make_pair(this->state_names[s], this->symbol_names[symbol])];
+                for (stateId to : this->transitions[s][symbol]) {
+                    targets.insert(this->state_names[to]);
+                }
+            }
+        }
+        return transitions;
     }
 
     /**
-     * @brief Gets all the symbols of the FA's alphabet
+     * @brief Gets all the symbols of the FA's alphabet. A slow compatibility helper that copies
+     * the names into a new set on every call. Prefer getSymbolCount and isAlphabetSymbol
      * 
      * @return A set of strings that contains all the symbols of the FA's alphabet
      */
-    std::set<std::string> getAlphabet() {
-        return this->alphabet;
+    std::set<std::string> getAlphabet() const {
+        std::set<std::string> symbols;
+        for (size_t symbol = 0; symbol < this->symbol_names.size(); symbol++) {
+            if (this->alphabet[symbol]) {
+                symbols.insert(this->symbol_names[symbol]);
+            }
+        }
+        return symbols;
     }
 
     /**
@@ -221,11 +958,11 @@ public:
      * 
      * @return true if the FA is deterministic. false otherwise
      */
-    bool isDeterministic() {
+    bool isDeterministic() const {
         if (this->hasLambda()) return false;
-        for (state s : this->states) {
-            for (std::string symbol : this->alphabet) {
-                if (this->transite(s,symbol).size() > 1) {
+        for (stateId s = 0; s < this->state_names.size(); s++) {
+            for (const stateList& targets : this->transitions[s]) {
+                if (targets.size() > 1) {
                     return false;
                 }
             }
@@ -238,17 +975,8 @@ public:
      * 
      * @return true if the FA has lambda transitions. false otherwise
      */
-    bool hasLambda() {
-        for (auto transition : this->transitions) {
-            if (transition.first.second.length() > 1) {
-                continue;
-            }
-            char c = transition.first.second[0];
-            if (c == '&') {
-                return true;
-            }
-        }
-        return false;
+    bool hasLambda() const {
+        return this->lambda_transitions > 0;
     }
 
     // FA Operations
@@ -260,42 +988,33 @@ public:
             std::cout << "The FA has lambda transitions. It is not possible to remove unreachable states yet." << std::endl;
             return;
         }
-        
+
         if (!this->isDeterministic()) {
             std::cout << "The FA is not deterministic. It is not possible to remove unreachable states yet." << std::endl;
             return;
         }
 
-        std::set<state> reachable_states;
-        std::set<state> new_reachable_states;
-        reachable_states.insert(this->initial_state);
-        new_reachable_states.insert(this->initial_state);
+        if (this->initial_state == NO_STATE) {
+            return;
+        }
+
+        std::vector<bool> reachable_states(this->state_names.size(), false);
+        stateList new_reachable_states;
+        reachable_states[this->initial_state] = true;
+        new_reachable_states.push_back(this->initial_state);
         while (new_reachable_states.size() > 0) {
-            std::set<state> aux;
-            for (state s : new_reachable_states) {
-                for (std::string symbol : this->alphabet) {
-                    if (this->transite(s, symbol).size() != 1) continue;
-                    state next_state = *this->transite(s, symbol).begin();
-                    if (!has(reachable_states,next_state)) {
-                        aux.insert(next_state);
+            stateId s = new_reachable_states.back();
+            new_reachable_states.pop_back();
+            for (stateList& targets : this->transitions[s]) {
+                for (stateId next_state : targets) {
+                    if (!reachable_states[next_state]) {
+                        reachable_states[next_state] = true;
+                        new_reachable_states.push_back(next_state);
                     }
                 }
             }
-            new_reachable_states = aux;
-            reachable_states.insert(new_reachable_states.begin(), new_reachable_states.end());
-        }
-        std::set<state> unreachable_states;
-        for (state s : this->states) {
-            if (!has(reachable_states, s)) {
-                unreachable_states.insert(s);
-            }
-        }
-        for (state s : unreachable_states) {
-            this->states.erase(s);
-            for (std::string symbol : this->alphabet) {
-                this->transitions.erase(std::make_pair(s, symbol));
-            }
         }
+        this->keepStates(reachable_states);
     }
 
     /**
@@ -304,41 +1023,14 @@ public:
      * @param s The state to be renamed
      * @param new_name The new name of the state
      */
-    void renameState(state s, std::string new_name) {
-        // Renaming state
-        this->states.erase(s);
-        this->addState(new_name);
-        
-        std::map<transition, std::set<state>> iterTransitions = this->getTransitions();
-        // Updating transitions
-        for (auto const& aTransition : iterTransitions) {
-            if (aTransition.second.size() == 0) continue; // No transition
-
-            transition fTransition = aTransition.first;
-
-            // Has transition from it
-            if (strcmp(fTransition.first.c_str(),s.c_str()) == 0) {
-                this->transitions[std::make_pair(new_name, fTransition.second)] = aTransition.second;
-                this->transitions.erase(fTransition);
-                fTransition = std::make_pair(new_name, fTransition.second);
-            }
-            // Has transition to it
-            if (has(aTransition.second, s)) {
-                this->transitions[fTransition].insert(new_name);
-                this->transitions[fTransition].erase(s);
-            }
-        }
-
-        // Updating initial state
-        if (this->initial_state == s) {
-            this->setInitialState(new_name);
-        }
-
-        // Updating final states
-        if (this->isFinalState(s)) {
-            this->final_states.erase(s);
-            this->addFinalState(new_name);
+    void renameState(const state& s, const std::string& new_name) {
+        stateId id = this->getStateId(s);
+        if (id == NO_STATE || new_name.length() == 0 || this->getStateId(new_name) != NO_STATE) {
+            return;
         }
+        this->state_ids.erase(s);
+        this->state_ids[new_name] = id;
+        this->state_names[id] = new_name;
     }
 
     /**
@@ -347,14 +1039,19 @@ public:
      */
     void renameAutomatonStates() {
         int state_value = 0;
-        std::set<state> theStates = this->getStates();
-        for (state s : theStates) {
-            while (has(theStates,std::to_string(state_value))) {
+        std::vector<std::string> new_names(this->state_names.size());
+        for (stateId s : this->getStatesByName()) {
+            while (this->state_ids.find(std::to_string(state_value)) != this->state_ids.end()) {
                 state_value++;
             }
-            this->renameState(s, std::to_string(state_value));
+            new_names[s] = std::to_string(state_value);
             state_value++;
         }
+        this->state_ids.clear();
+        for (stateId id = 0; id < new_names.size(); id++) {
+            this->state_ids[new_names[id]] = id;
+        }
+        this->state_names = new_names;
     }
 
     /**
@@ -372,7 +1069,7 @@ public:
         }
 
         int error_state_value = 0;
-        for (state s : this->getStates()) {
+        for (state s : this->state_names) {
             try {
                 if (std::stoi(s) > error_state_value) {
                     error_state_value = std::stoi(s);
@@ -382,83 +1079,166 @@ public:
             }
         }
         error_state_value++;
-        state error_state = std::to_string(error_state_value);
-        this->addState(error_state);
-        for (state s : this->getStates()) {
-            for (std::string symbol : this->getAlphabet()) {
-                if (this->transitions.find(std::make_pair(s, symbol)) == this->transitions.end()) {
-                    this->addTransition(s, symbol, error_state);
+        stateId error_state = this->internState(std::to_string(error_state_value));
+        for (stateId s = 0; s < this->state_names.size(); s++) {
+            for (symbolId symbol = 1; symbol < this->symbol_names.size(); symbol++) {
+                if (this->alphabet[symbol] && this->transiteId(s, symbol).empty()) {
+                    this->addTransitionId(s, symbol, error_state);
                 }
             }
         }
     }
 
     /**
-     * @brief Tests if a sentence is accepted by the FA
+     * @brief Gets the symbol read by each byte, considering only the single-character symbols
+     * 
+     * @return An array indexed by byte with the symbols' IDs. NO_SYMBOL for bytes that are not
+     * a symbol
+     */
+    std::array<symbolId, 256> getByteSymbols() const {
+        std::array<symbolId, 256> byte_symbols;
+        byte_symbols.fill(NO_SYMBOL);
+        for (size_t symbol = 1; symbol < this->symbol_names.size(); symbol++) {
+            if (this->symbol_names[symbol].length() == 1) {
+                byte_symbols[(unsigned char) this->symbol_names[symbol][0]] = symbol;
+            }
+        }
+        return byte_symbols;
+    }
+
+    /**
+     * @brief Gets the tokenizer that splits sentences into the symbols of the FA. It is built
+     * as the symbols are interned, so getting it costs nothing
+     * 
+     * @return The tokenizer
+     */
+    const SymbolTokenizer& getTokenizer() const {
+        return this->tokenizer;
+    }
+
+    /**
+     * @brief Tests if a sentence is accepted by the FA. The FA is simulated keeping the set of
+     * all the states it can be in, so each character is read only once, in O(states + transitions)
      * 
      * @param sentence The sentence to be tested
+     * @param current_state The state from which the test starts. The initial state if empty
      * @return true if the sentence is accepted by the FA. false otherwise
      */
-    bool testSentence(std::string sentence, state current_state = "") {
-        if (current_state.empty()) {
-            current_state = this->initial_state;
-        }
+    bool testSentence(const std::string& sentence, const state& current_state = "") const {
+        stateId current_id = current_state.empty() ? this->initial_state : this->getStateId(current_state);
+        return this->matches(sentence.data(), sentence.length(), current_id);
+    }
 
-        if (sentence.empty()) {
-            return this->isFinalState(current_state);
+    /**
+     * @brief Tests if a sentence is accepted by the FA, simulating it over sets of states. The
+     * sentence is split into symbols by longest match, so multi-character symbols are read too
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @param current_id The ID of the state from which the test starts
+     * @return true if the sentence is accepted by the FA. false otherwise
+     */
+    bool matches(const char* sentence, size_t length, stateId current_id) const {
+        std::vector<symbolId> symbols;
+        if (!this->tokenizer.tokenize(sentence, length, symbols)) {
+            return false;
         }
+        return this->matchesSymbols(symbols.data(), symbols.size(), current_id);
+    }
 
-        std::string symbol(1, sentence[0]);
-        if (this->transite(current_state, symbol).empty()) {
+    /**
+     * @brief Tests if a sentence, already split into symbols, is accepted by the FA, simulating
+     * it over sets of states
+     * 
+     * @param symbols The IDs of the symbols of the sentence
+     * @param length The number of symbols
+     * @param current_id The ID of the state from which the test starts
+     * @return true if the sentence is accepted by the FA. false otherwise
+     */
+    bool matchesSymbols(const symbolId* symbols, size_t length, stateId current_id) const {
+        if (current_id == NO_STATE) {
             return false;
         }
 
-        if (this->transite(current_state, "&").size() > 0) {
-            for (state s : this->transite(current_state, "&")) {
-                if (this->testSentence(sentence, s)) {
-                    return true;
-                }
+        std::vector<uint32_t> marks(this->state_names.size(), 0);
+        uint32_t generation = 1;
+        stateList current_states;
+        stateList next_states;
+        marks[current_id] = generation;
+        current_states.push_back(current_id);
+        this->closeByLambda(current_states, marks, generation);
+
+        for (size_t i = 0; i < length; i++) {
+            symbolId symbol = symbols[i];
+            if (symbol == LAMBDA || symbol >= this->symbol_names.size()) {
+                return false;
             }
-        }
 
-        for (state s : this->transite(current_state, symbol)) {
-            if (sentence.length() == 1) {
-                if (this->testSentence("", s)) {
-                    return true;
-                }
-            } else {
-                if (this->testSentence(sentence.substr(1), s)) {
-                    return true;
+            generation++;
+            next_states.clear();
+            for (stateId s : current_states) {
+                for (stateId next_state : this->transiteId(s, symbol)) {
+                    if (marks[next_state] != generation) {
+                        marks[next_state] = generation;
+                        next_states.push_back(next_state);
+                    }
                 }
             }
+            this->closeByLambda(next_states, marks, generation);
+
+            if (next_states.empty()) {
+                return false;
+            }
+            std::swap(current_states, next_states);
         }
 
+        for (stateId s : current_states) {
+            if (this->final_states[s]) {
+                return true;
+            }
+        }
         return false;
     }
 
+    /**
+     * @brief Get all the states that can be reached from a given state by lambda transitions
+     * 
+     * @param starting_state The ID of the state from which the lambda transitions start
+     * @return A list with the IDs of the states that can be reached from the starting state by
+     * lambda transitions, the starting state included
+     */
+    stateList getLambdaClosureId(stateId starting_state) const {
+        stateList closure;
+        std::vector<bool> visited(this->state_names.size(), false);
+        closure.push_back(starting_state);
+        visited[starting_state] = true;
+        for (size_t i = 0; i < closure.size(); i++) {
+            for (stateId next_state : this->transiteId(closure[i], LAMBDA)) {
+                if (!visited[next_state]) {
+                    visited[next_state] = true;
+                    closure.push_back(next_state);
+                }
+            }
+        }
+        return closure;
+    }
+
     /**
      * @brief Get all the states that can be reached from a given state by lambda transitions
      * 
      * @param starting_state The state from which the lambda transitions start
      * @return A set of states that can be reached from the starting state by lambda transitions
      */
-    std::set<state> getStatesFromLambdaTransition(state starting_state) {
+    std::set<state> getStatesFromLambdaTransition(const state& starting_state) const {
         std::set<state> states_from_lambda_transition;
-        std::set<state> new_states_from_lambda_transition;
-        states_from_lambda_transition.insert(starting_state);
-        new_states_from_lambda_transition.insert(starting_state);
-        while (new_states_from_lambda_transition.size() > 0) {
-            std::set<state> aux;
-            for (state s : new_states_from_lambda_transition) {
-                for (state next_state : this->transite(s, "&")) {
-                    if (!has(states_from_lambda_transition, next_state)) {
-                        aux.insert(next_state);
-                    }
-                }
-            }
-            new_states_from_lambda_transition = aux;
-            states_from_lambda_transition.insert(new_states_from_lambda_transition.begin(), new_states_from_lambda_transition.end());
+        stateId id = this->getStateId(starting_state);
+        if (id == NO_STATE) {
+            states_from_lambda_transition.insert(starting_state);
+            return states_from_lambda_transition;
+        }
+        for (stateId s : this->getLambdaClosureId(id)) {
+            states_from_lambda_transition.insert(this->state_names[s]);
         }
         return states_from_lambda_transition;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,209 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include "fa.cpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+// Size of the buffer of a JffWriter
+const size_t JFF_WRITER_BUFFER_SIZE = 1 << 16;
+
+/**
+ * @brief Writes a FA to a JFLAP (.jff) file in a single pass over its states and transitions,
+ * without building a XML document in memory. The text is gathered in a fixed buffer that is
+ * written to the file descriptor whenever it fills up, so memory use does not grow with the
+ * size of the FA.
+ * 
+ * The header of the file, that used to be parsed from Data/skeleton.jff, is written inline.
+ */
+class JffWriter {
+private:
+    std::string file_path;
+    std::vector<char> buffer;
+    size_t used;
+#ifndef _WIN32
+    int fd;
+#else
+    std::ofstream file;
+#endif
+
+    /**
+     * @brief Writes the buffer to the file and empties it
+     * 
+     * @throws std::runtime_error If the file can not be written
+     */
+    void flush() {
+#ifndef _WIN32
+        size_t written = 0;
+        while (written < this->used) {
+            ssize_t result = ::write(this->fd, this->buffer.data() + written, this->used - written);
+            if (result < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("Could not write file " + this->file_path + ".");
+            }
+            written += result;
+        }
+#else
+        this->file.write(this->buffer.data(), this->used);
+        if (!this->file) {
+            throw std::runtime_error("Could not write file " + this->file_path + ".");
+        }
+#endif
+        this->used = 0;
+    }
+
+    /**
+     * @brief Appends text to the buffer, flushing it when it is full
+     * 
+     * @param text The text
+     */
+    void put(std::string_view text) {
+        while (!text.empty()) {
+            if (this->used == this->buffer.size()) {
+                this->flush();
+            }
+            size_t length = std::min(text.length(), this->buffer.size() - this->used);
+            memcpy(this->buffer.data() + this->used, text.data(), length);
+            this->used += length;
+            text.remove_prefix(length);
+        }
+    }
+
+    /**
+     * @brief Appends text to the buffer, escaping the characters that are special in XML
+     * 
+     * @param text The text
+     */
+    void putEscaped(std::string_view text) {
+        size_t start = 0;
+        for (size_t i = 0; i < text.length(); i++) {
+            const char* entity;
+            switch (text[i]) {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"': entity = "&quot;"; break;
+            default: continue;
+            }
+            this->put(text.substr(start, i - start));
+            this->put(entity);
+            start = i + 1;
+        }
+        this->put(text.substr(start));
+    }
+
+    /**
+     * @brief Appends an element with text content, as in <name>value</name>
+     * 
+     * @param indentation The tabs before the element
+     * @param name The element's name
+     * @param value The element's text, escaped
+     */
+    void putElement(std::string_view indentation, std::string_view name, std::string_view value) {
+        this->put(indentation);
+        this->put("<");
+        this->put(name);
+        this->put(">");
+        this->putEscaped(value);
+        this->put("</");
+        this->put(name);
+        this->put(">\n");
+    }
+
+public:
+    /**
+     * @brief Creates a file to write a FA to. An existing file is replaced
+     * 
+     * @param file_path The file's path
+     * @throws std::runtime_error If the file can not be created
+     */
+    JffWriter(const std::string& file_path) {
+        this->file_path = file_path;
+        this->buffer = std::vector<char>(JFF_WRITER_BUFFER_SIZE);
+        this->used = 0;
+#ifndef _WIN32
+        this->fd = ::open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (this->fd < 0) {
+            throw std::runtime_error("Could not create file " + file_path + ".");
+        }
+#else
+        this->file.open(file_path, std::ios::binary | std::ios::trunc);
+        if (!this->file.is_open()) {
+            throw std::runtime_error("Could not create file " + file_path + ".");
+        }
+#endif
+    }
+
+    ~JffWriter() {
+#ifndef _WIN32
+        if (this->fd >= 0) {
+            ::close(this->fd);
+        }
+#endif
+    }
+
+    JffWriter(const JffWriter&) = delete;
+    JffWriter& operator=(const JffWriter&) = delete;
+
+    /**
+     * @brief Writes a FA to the file, which is closed afterwards. λ-transitions read nothing
+     * 
+     * @param fa The FA
+     * @throws std::runtime_error If the file can not be written
+     */
+    void write(const FA& fa) {
+        this->put("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?><!--Created with JFLAP 6.4.-->\n");
+        this->put("<structure>\n\t<type>fa</type>\n\t<automaton>\n");
+
+        const std::vector<std::string>& state_names = fa.getStateNames();
+        for (stateId s = 0; s < state_names.size(); s++) {
+            this->put("\t\t<state id=\"");
+            this->putEscaped(state_names[s]);
+            this->put("\" name=\"q");
+            this->putEscaped(state_names[s]);
+            this->put("\">\n\t\t\t<x>0</x>\n\t\t\t<y>0</y>\n");
+            if (s == fa.getInitialStateId()) {
+                this->put("\t\t\t<initial />\n");
+            }
+            if (fa.isFinalStateId(s)) {
+                this->put("\t\t\t<final />\n");
+            }
+            this->put("\t\t</state>\n");
+        }
+
+        for (transitionId t : fa.getTransitionView()) {
+            this->put("\t\t<transition>\n");
+            this->putElement("\t\t\t", "from", state_names[t.from]);
+            this->putElement("\t\t\t", "to", state_names[t.to]);
+            this->putElement("\t\t\t", "read", t.read == LAMBDA ? std::string_view() : std::string_view(fa.getSymbolName(t.read)));
+            this->put("\t\t</transition>\n");
+        }
+
+        this->put("\t</automaton>\n</structure>\n");
+        this->flush();
+#ifndef _WIN32
+        int result = ::close(this->fd);
+        this->fd = -1;
+        if (result != 0) {
+            throw std::runtime_error("Could not write file " + this->file_path + ".");
+        }
+#else
+        this->file.close();
+#endif
+    }
+};
@@ -0,0 +1,169 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "fa.cpp"
+
+/**
+ * @brief The lambda closures of all the states of a FA, computed at once. The graph of lambda
+ * transitions is condensed into its strongly connected components with Tarjan's algorithm:
+ * all the states of a component have the same closure, and the components come out in reverse
+ * topological order, so the closure of each one is the union of its states and the already
+ * computed closures of its successors. Each closure is stored once per component, sorted, in a
+ * single pool.
+ */
+class LambdaClosure {
+private:
+    std::vector<uint32_t> component_of;
+    // The closure of component c is pool[offsets[c]..offsets[c+1]]
+    std::vector<stateId> pool;
+    std::vector<size_t> offsets;
+
+public:
+    // Constructors
+    LambdaClosure() {
+        this->component_of = std::vector<uint32_t>();
+        this->pool = std::vector<stateId>();
+        this->offsets = std::vector<size_t>(1, 0);
+    }
+
+    /**
+     * @brief Computes the lambda closures of all the states of a FA
+     * 
+     * @param fa The FA
+     */
+    LambdaClosure(const FA& fa) : LambdaClosure() {
+        const uint32_t UNVISITED = UINT32_MAX;
+        size_t state_count = fa.getStateCount();
+        this->component_of.assign(state_count, UNVISITED);
+
+        std::vector<uint32_t> index(state_count, UNVISITED);
+        std::vector<uint32_t> lowlink(state_count, 0);
+        std::vector<bool> on_stack(state_count, false);
+        stateList stack;
+        // Depth-first search frames: a state and the next lambda transition to follow
+        std::vector<std::pair<stateId, size_t>> frames;
+        uint32_t next_index = 0;
+
+        // Scratch bitset for the unions
+        std::vector<uint64_t> in_closure(state_count / 64 + 1, 0);
+        stateList closure;
+
+        for (stateId root = 0; root < state_count; root++) {
+            if (index[root] != UNVISITED) continue;
+
+            index[root] = lowlink[root] = next_index++;
+            stack.push_back(root);
+            on_stack[root] = true;
+            frames.push_back(std::make_pair(root, 0));
+
+            while (!frames.empty()) {
+                stateId v = frames.back().first;
+                const stateList& lambda_targets = fa.transiteId(v, LAMBDA);
+
+                if (frames.back().second < lambda_targets.size()) {
+                    stateId w = lambda_targets[frames.back().second++];
+                    if (index[w] == UNVISITED) {
+                        index[w] = lowlink[w] = next_index++;
+                        stack.push_back(w);
+                        on_stack[w] = true;
+                        frames.push_back(std::make_pair(w, 0));
+                    } else if (on_stack[w]) {
+                        lowlink[v] = std::min(lowlink[v], index[w]);
+                    }
+                    continue;
+                }
+
+                frames.pop_back();
+                if (!frames.empty()) {
+                    stateId parent = frames.back().first;
+                    lowlink[parent] = std::min(lowlink[parent], lowlink[v]);
+                }
+                if (lowlink[v] != index[v]) continue;
+
+                // v is the root of a component: pop it and compute its closure
+                uint32_t component = this->offsets.size() - 1;
+                size_t component_begin = stack.size();
+                do {
+                    component_begin--;
+                } while (stack[component_begin] != v);
+
+                closure.clear();
+                for (size_t i = component_begin; i < stack.size(); i++) {
+                    stateId s = stack[i];
+                    on_stack[s] = false;
+                    this->component_of[s] = component;
+                    in_closure[s / 64] |= ((uint64_t) 1) << (s % 64);
+                    closure.push_back(s);
+                }
+                for (size_t i = component_begin; i < stack.size(); i++) {
+                    for (stateId w : fa.transiteId(stack[i], LAMBDA)) {
+                        uint32_t successor = this->component_of[w];
+                        if (successor == component) continue;
+                        for (size_t j = this->offsets[successor]; j < this->offsets[successor + 1]; j++) {
+                            stateId u = this->pool[j];
+                            uint64_t bit = ((uint64_t) 1) << (u % 64);
+                            if (!(in_closure[u / 64] & bit)) {
+                                in_closure[u / 64] |= bit;
+                                closure.push_back(u);
+                            }
+                        }
+                    }
+                }
+                stack.resize(component_begin);
+
+                for (stateId s : closure) {
+                    in_closure[s / 64] = 0;
+                }
+                std::sort(closure.begin(), closure.end());
+                this->pool.insert(this->pool.end(), closure.begin(), closure.end());
+                this->offsets.push_back(this->pool.size());
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the component of a state. States of the same component have the same closure
+     * 
+     * @param s The state's ID
+     * @return The component's ID
+     */
+    uint32_t getComponent(stateId s) const {
+        return this->component_of[s];
+    }
+
+    /**
+     * @brief Gets the number of components
+     * 
+     * @return The number of components
+     */
+    size_t getComponentCount() const {
+        return this->offsets.size() - 1;
+    }
+
+    /**
+     * @brief Gets the lambda closure of a component
+     * 
+     * @param component The component's ID
+     * @return The sorted states of the closure
+     */
+    stateSpan getComponentClosure(uint32_t component) const {
+        return stateSpan(this->pool.data() + this->offsets[component], this->pool.data() + this->offsets[component + 1]);
+    }
+
+    /**
+     * @brief Gets the lambda closure of a state, in O(1)
+     * 
+     * @param s The state's ID
+     * @return The sorted states that can be reached from s by lambda transitions, s included
+     */
+    stateSpan getClosure(stateId s) const {
+        return this->getComponentClosure(this->component_of[s]);
+    }
+};
@@ -0,0 +1,274 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include "fa.cpp"
+#include "subsetTable.cpp"
+#include "lambdaClosure.cpp"
+
+// Marks a transition of the cache that was not computed yet
+const uint32_t LAZY_UNKNOWN = UINT32_MAX;
+// Default number of bytes the cache of a LazyDfa may use before it is cleared
+const size_t LAZY_DFA_MEMORY_BUDGET = 16 << 20;
+
+/**
+ * @brief A DFA built on the fly from a NFA (λ-transitions allowed) while sentences are matched.
+ * Each state of the DFA is a λ-closed set of states of the NFA, and a transition is only
+ * computed, with the lambda closures of the NFA, the first time the input takes it; after that
+ * it is read from a table like in a DFA. Only the part of the powerset the input actually visits
+ * is ever built.
+ * 
+ * The cache is bounded: when it goes over its memory budget it is cleared and rebuilt from the
+ * state being visited, so matching never needs more than the budget, no matter how large the
+ * full DFA would be.
+ * 
+ * A LazyDfa modifies its cache while matching, so each thread must use its own copy. Copies
+ * share the NFA and its closures, which must outlive them.
+ */
+class LazyDfa {
+private:
+    const FA* fa;
+    std::shared_ptr<const LambdaClosure> closures;
+    std::array<symbolId, 256> byte_symbols;
+    size_t symbol_count;
+    size_t memory_budget;
+
+    // The cache. transitions[d * symbol_count + symbol] is the next state of d reading symbol
+    SubsetTable subsets;
+    std::vector<uint32_t> transitions;
+    std::vector<bool> accepting;
+    uint32_t initial_state;
+    uint32_t dead_state;
+    size_t clear_count;
+
+    // Scratch space of computeTransition
+    std::vector<uint32_t> marks;
+    uint32_t generation;
+    stateList next_states;
+
+    /**
+     * @brief Adds a state to the cache, if it is not there yet
+     * 
+     * @param states The sorted states of the NFA that make up the state
+     * @return The ID of the state
+     */
+    uint32_t addState(const stateList& states) {
+        bool inserted;
+        uint32_t id = this->subsets.intern(states, &inserted);
+        if (inserted) {
+            this->transitions.resize(this->transitions.size() + this->symbol_count, LAZY_UNKNOWN);
+            bool is_final = false;
+            for (stateId s : states) {
+                if (this->fa->isFinalStateId(s)) {
+                    is_final = true;
+                    break;
+                }
+            }
+            this->accepting.push_back(is_final);
+        }
+        return id;
+    }
+
+    /**
+     * @brief Clears the cache, leaving only the dead and the initial states
+     */
+    void resetCache() {
+        this->subsets.clear();
+        this->transitions.clear();
+        this->accepting.clear();
+
+        this->dead_state = this->addState(stateList());
+        std::fill(this->transitions.begin(), this->transitions.end(), this->dead_state);
+
+        stateId initial_state = this->fa->getInitialStateId();
+        if (initial_state == NO_STATE) {
+            this->initial_state = this->dead_state;
+        } else {
+            stateSpan closure = this->closures->getClosure(initial_state);
+            this->initial_state = this->addState(stateList(closure.begin(), closure.end()));
+        }
+    }
+
+    /**
+     * @brief Computes a transition of the DFA and stores it in the cache. If the cache is over
+     * its budget, it is cleared first and the transition is not stored, since its origin is gone
+     * 
+     * @param from The ID of the origin state
+     * @param symbol The symbol read
+     * @return The ID of the destination state
+     */
+    uint32_t computeTransition(uint32_t from, symbolId symbol) {
+        if (++this->generation == 0) {
+            std::fill(this->marks.begin(), this->marks.end(), 0);
+            this->generation = 1;
+        }
+
+        this->next_states.clear();
+        const stateId* states = this->subsets.getStates(from);
+        size_t size = this->subsets.getSize(from);
+        for (size_t i = 0; i < size; i++) {
+            for (stateId t : this->fa->transiteId(states[i], symbol)) {
+                for (stateId u : this->closures->getClosure(t)) {
+                    if (this->marks[u] != this->generation) {
+                        this->marks[u] = this->generation;
+                        this->next_states.push_back(u);
+                    }
+                }
+            }
+        }
+        std::sort(this->next_states.begin(), this->next_states.end());
+
+        if (this->getMemoryUsage() > this->memory_budget) {
+            this->clear_count++;
+            this->resetCache();
+            return this->addState(this->next_states);
+        }
+
+        uint32_t to = this->addState(this->next_states);
+        this->transitions[from * this->symbol_count + symbol] = to;
+        return to;
+    }
+
+    /**
+     * @brief Gets the next state of the cache, computing it if it is not known yet
+     * 
+     * @param from The current state of the cache
+     * @param symbol The ID of the symbol read
+     * @return The next state of the cache
+     */
+    uint32_t step(uint32_t from, symbolId symbol) {
+        uint32_t next = this->transitions[from * this->symbol_count + symbol];
+        if (next == LAZY_UNKNOWN) {
+            next = this->computeTransition(from, symbol);
+        }
+        return next;
+    }
+
+public:
+    // Constructors
+    LazyDfa() {
+        this->fa = nullptr;
+        this->closures = nullptr;
+        this->byte_symbols.fill(NO_SYMBOL);
+        this->symbol_count = 0;
+        this->memory_budget = LAZY_DFA_MEMORY_BUDGET;
+        this->subsets = SubsetTable();
+        this->transitions = std::vector<uint32_t>();
+        this->accepting = std::vector<bool>();
+        this->initial_state = 0;
+        this->dead_state = 0;
+        this->clear_count = 0;
+        this->marks = std::vector<uint32_t>();
+        this->generation = 0;
+        this->next_states = stateList();
+    }
+
+    /**
+     * @brief Prepares a NFA to be matched lazily
+     * 
+     * @param fa The NFA. It must outlive the LazyDfa and its copies
+     * @param memory_budget The number of bytes the cache may use before it is cleared
+     */
+    LazyDfa(const FA& fa, size_t memory_budget = LAZY_DFA_MEMORY_BUDGET) : LazyDfa() {
+        this->fa = &fa;
+        this->closures = std::make_shared<const LambdaClosure>(fa);
+        this->byte_symbols = fa.getByteSymbols();
+        this->symbol_count = fa.getSymbolCount();
+        this->memory_budget = memory_budget;
+        this->marks = std::vector<uint32_t>(fa.getStateCount(), 0);
+        this->resetCache();
+    }
+
+    // LazyDfa Information
+    /**
+     * @brief Gets the number of states in the cache, the dead state included
+     * 
+     * @return The number of states
+     */
+    size_t getCachedStateCount() const {
+        return this->subsets.size();
+    }
+
+    /**
+     * @brief Gets the number of times the cache was cleared for going over its budget
+     * 
+     * @return The number of times
+     */
+    size_t getCacheClearCount() const {
+        return this->clear_count;
+    }
+
+    /**
+     * @brief Gets the memory used by the cache: the subsets with their index, the transitions
+     * and the accepting flags
+     * 
+     * @return The number of bytes
+     */
+    size_t getMemoryUsage() const {
+        return this->subsets.getMemoryUsage() +
+            this->transitions.size() * sizeof(uint32_t) +
+            (this->accepting.size() + 7) / 8;
+    }
+
+    // Matching
+    /**
+     * @brief Tests if a sentence is accepted by the NFA, building the transitions it takes
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool matches(const char* sentence, size_t length) {
+        if (this->fa == nullptr) {
+            return false;
+        }
+
+        const unsigned char* input = (const unsigned char*) sentence;
+        uint32_t current = this->initial_state;
+        for (size_t i = 0; i < length; i++) {
+            symbolId symbol = this->byte_symbols[input[i]];
+            if (symbol == NO_SYMBOL) {
+                return false;
+            }
+            current = this->step(current, symbol);
+            if (current == this->dead_state) {
+                return false;
+            }
+        }
+        return this->accepting[current];
+    }
+
+    /**
+     * @brief Tests if a sentence, already split into symbols, is accepted by the NFA, building
+     * the transitions it takes
+     * 
+     * @param symbols The IDs of the symbols of the sentence, as in the NFA
+     * @param length The number of symbols
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool matchesSymbols(const symbolId* symbols, size_t length) {
+        if (this->fa == nullptr) {
+            return false;
+        }
+
+        uint32_t current = this->initial_state;
+        for (size_t i = 0; i < length; i++) {
+            if (symbols[i] == LAMBDA || symbols[i] >= this->symbol_count) {
+                return false;
+            }
+            current = this->step(current, symbols[i]);
+            if (current == this->dead_state) {
+                return false;
+            }
+        }
+        return this->accepting[current];
+    }
+};
@@ -6,27 +6,54 @@
 #include <iostream>
 #include "pugixml/pugixml.hpp"
 #include "algorithms.cpp"
+#include "compiledDfa.cpp"
+#include "matcher.cpp"
+#include "batchMatcher.cpp"
+#include "mappedFile.cpp"
+#include "searcher.cpp"
+#include "patternSet.cpp"
+#include "codeGenerator.cpp"
+#include "jffWriter.cpp"
+#include "dfaCache.cpp"
+#include "staticDfa.cpp"
 #include <chrono>
 #include <fstream>
+#include <sstream>
 
 // #define BASE_PATH "./../" // Debug path
 #define BASE_PATH "./../../" // Execution path
 
 
 FA loadDfaFromFile(bool* faNullFlag);
+FA loadFAFromJffFile(const std::string& file_path);
 FA loadDfaFromERFile(bool* faNullFlag);
 std::string treatExpression(std::string expression);
 std::string treatStringChar(std::string stringChar);
-void exportDfaToFile(FA fa);
+void exportDfaToFile(const FA& fa);
+void exportDfaToHeader(const FA& fa);
 FA minimizeDFA(FA fa);
 FA generateDfa(int n);
 FA loadFAFromRegularExpression(bool* faNullFlag, std::string regular_expression);
 FA transformNfaToDfa(FA fa);
 FA transformNfaLToNfa(FA fa);
-void testMultipleSentences(FA fa);
-
-int main()
+void testMultipleSentences(const FA& fa);
+void testMultipleSentences(const Matcher& matcher);
+void saveCompiledDfa(const FA& fa);
+void testSentencesWithCompiledDfa();
+void testSentencesWithCachedRE();
+void searchTextFile(const FA& fa);
+void testSentencesAgainstPatterns();
+size_t getTransitionCount(const FA& fa);
+int runCommandLine(const std::vector<std::string>& arguments);
+void printUsage(std::ostream& out);
+
+int main(int argc, char* argv[])
 {
+    // With arguments, the commands are run without the menu
+    if (argc > 1) {
+        return runCommandLine(std::vector<std::string>(argv + 1, argv + argc));
+    }
+
     FA fa = FA();
     bool faNullFlag = true;
     bool quit = false;
@@ -40,6 +67,14 @@ int main()
         \n5. Export FA to XML file\
         \n6. Test single sentence\
         \n7. Test multiple sentences\
+        \n8. Minimize DFA\
+        \n9. Search text file\
+        \n10. Test multiple sentences against multiple REs\
+        \n11. Export DFA to C++ header\
+        \n12. Save compiled DFA to binary file\
+        \n13. Test multiple sentences with binary DFA file\
+        \n14. Load FA from XML file\
+        \n15. Test multiple sentences with cached RE\
         \n0. Quit\
         \nChoose option: ";
         int option;
@@ -103,6 +138,46 @@ int main()
                 testMultipleSentences(fa);
                 break;
             }
+        case 8:
+            if (faNullFlag) {
+                std::cout << "\nNo FA loaded yet.\n\n";
+                break;
+            }
+            fa = minimizeDFA(fa);
+            break;
+        case 9:
+            if (faNullFlag) {
+                std::cout << "\nNo FA loaded yet.\n\n";
+                break;
+            }
+            searchTextFile(fa);
+            break;
+        case 10:
+            testSentencesAgainstPatterns();
+            break;
+        case 11:
+            if (faNullFlag) {
+                std::cout << "\nNo FA loaded yet.\n\n";
+                break;
+            }
+            exportDfaToHeader(fa);
+            break;
+        case 12:
+            if (faNullFlag) {
+                std::cout << "\nNo FA loaded yet.\n\n";
+                break;
+            }
+            saveCompiledDfa(fa);
+            break;
+        case 13:
+            testSentencesWithCompiledDfa();
+            break;
+        case 14:
+            fa = loadDfaFromFile(&faNullFlag);
+            break;
+        case 15:
+            testSentencesWithCachedRE();
+            break;
         default:
             quit = true;
             break;
@@ -112,6 +187,171 @@ int main()
     return 0;
 }
 
+/**
+ * @brief Prints how the program is run from the command line
+ * 
+ * @param out The stream to print to
+ */
+void printUsage(std::ostream& out) {
+    out << "Usage: main <command> [argument] [<command> [argument]]...\n"
+        << "The commands are run in order on the same FA, in a single process:\n"
+        << "  compile <re>     Builds a NFA-lambda from a regular expression\n"
+        << "  load <file>      Loads a FA from a JFLAP file\n"
+        << "  determinize      Removes the lambda transitions and determinizes the FA\n"
+        << "  minimize         Minimizes the DFA\n"
+        << "  match <file>     Tests each line of a file (- for the standard input), printing\n"
+        << "                   \"1<TAB>sentence\" if it is accepted or \"0<TAB>sentence\" otherwise\n"
+        << "  export <file>    Saves the FA: .h/.hpp as a C++ header, .dfa as a compiled DFA and\n"
+        << "                   anything else as a JFLAP file\n"
+        << "A \"key=value\" line is printed to the standard error after each command.\n"
+        << "Without arguments, the interactive menu is shown.\n";
+}
+
+/**
+ * @brief Counts the transitions of a FA
+ * 
+ * @param fa The FA
+ * @return The number of transitions, λ-transitions included
+ */
+size_t getTransitionCount(const FA& fa) {
+    size_t transition_count = 0;
+    for (stateId s = 0; s < fa.getStateCount(); s++) {
+        for (const stateList& targets : fa.getTransitionRow(s)) {
+            transition_count += targets.size();
+        }
+    }
+    return transition_count;
+}
+
+/**
+ * @brief Runs a pipeline of commands from the command line, without any prompt. Results go
+ * to the standard output and the statistics and errors to the standard error, so it can be
+ * run by scripts and job schedulers
+ * 
+ * @param arguments The command line arguments, without the program's name
+ * @return The exit code: 0 on success, 1 if a command failed and 2 if the arguments are
+ * invalid
+ */
+int runCommandLine(const std::vector<std::string>& arguments) {
+    if (arguments[0] == "help" || arguments[0] == "--help" || arguments[0] == "-h") {
+        printUsage(std::cout);
+        return 0;
+    }
+
+    FA fa = FA();
+    bool loaded = false;
+    for (size_t i = 0; i < arguments.size(); i++) {
+        const std::string& command = arguments[i];
+        bool needs_argument = command == "compile" || command == "load" || command == "match" || command == "export";
+        bool needs_fa = command != "compile" && command != "load";
+        if (!needs_argument && command != "determinize" && command != "minimize") {
+            std::cerr << "error: unknown command " << command << "\n";
+            printUsage(std::cerr);
+            return 2;
+        }
+        if (needs_argument && i + 1 >= arguments.size()) {
+            std::cerr << "error: " << command << " needs an argument\n";
+            printUsage(std::cerr);
+            return 2;
+        }
+        if (needs_fa && !loaded) {
+            std::cerr << "error: " << command << " needs a FA, from compile or load first\n";
+            return 2;
+        }
+        std::string argument = needs_argument ? arguments[++i] : "";
+
+        std::string details = "";
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        try {
+            if (command == "compile") {
+                fa = getFAFromRE(treatExpression(argument));
+                if (fa.getStateCount() == 0) {
+                    throw std::invalid_argument("Invalid regular expression.");
+                }
+                loaded = true;
+            } else if (command == "load") {
+                fa = loadFAFromJffFile(argument);
+                loaded = true;
+            } else if (command == "determinize") {
+                if (fa.hasLambda()) {
+                    fa = removeLambdaTransitions(fa);
+                }
+                if (!fa.isDeterministic()) {
+                    fa = determinizeFA(fa);
+                    fa.removeUnreachableStates();
+                }
+            } else if (command == "minimize") {
+                if (!fa.isDeterministic()) {
+                    throw std::invalid_argument("The FA is not deterministic. Run determinize first.");
+                }
+                fa = automatonMinimizationAlgorithm(fa, false);
+            } else if (command == "match") {
+                // Sentences from a file are matched in place, as in testMultipleSentences
+                MappedFile file;
+                std::string input;
+                std::vector<std::string_view> sentences;
+                if (argument == "-") {
+                    std::ostringstream contents;
+                    contents << std::cin.rdbuf();
+                    input = contents.str();
+                    std::string_view rest = input;
+                    while (!rest.empty()) {
+                        size_t newline = rest.find('\n');
+                        sentences.push_back(rest.substr(0, newline));
+                        rest.remove_prefix(newline == std::string_view::npos ? rest.length() : newline + 1);
+                    }
+                } else {
+                    if (!file.open(argument)) {
+                        throw std::runtime_error("Could not open file " + argument + ".");
+                    }
+                    sentences = file.getLines();
+                }
+
+                Matcher matcher = Matcher(fa);
+                BufferedWriter writer(std::cout);
+                size_t accepted = testSentencesInParallel(matcher, sentences, writer, 0, TSV_RESULTS);
+                details = " sentences=" + std::to_string(sentences.size()) + " accepted=" + std::to_string(accepted) + " engine=\"" + matcher.getEngineName() + "\"";
+            } else {
+                std::string extension = argument.substr(std::min(argument.length(), argument.rfind('.')));
+                if (extension == ".h" || extension == ".hpp") {
+                    // The file's name, without directories and extension, is the namespace
+                    size_t slash = argument.find_last_of("/\\");
+                    std::string name = argument.substr(slash == std::string::npos ? 0 : slash + 1);
+                    name = name.substr(0, name.rfind('.'));
+                    std::string header = generateDfaHeader(fa, name, TABLE_CODE);
+                    std::ofstream file(argument);
+                    file << header;
+                    if (!file) {
+                        throw std::runtime_error("Could not write file " + argument + ".");
+                    }
+                } else if (extension == ".dfa") {
+                    if (!fa.isDeterministic()) {
+                        throw std::invalid_argument("The FA is not deterministic. Run determinize first.");
+                    }
+                    CompiledDfa(fa).saveToFile(argument);
+                } else {
+                    JffWriter writer = JffWriter(argument);
+                    writer.write(fa);
+                }
+                details = " file=\"" + argument + "\"";
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "error: " << command << ": " << e.what() << "\n";
+            return 1;
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        std::cerr << "command=" << command
+            << " states=" << fa.getStateCount()
+            << " transitions=" << getTransitionCount(fa)
+            << " deterministic=" << (fa.isDeterministic() ? 1 : 0)
+            << details
+            << " time_us=" << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "\n";
+    }
+
+    return 0;
+}
+
 /**
  * @brief Loads a FA from a file that contains a FA
  * 
@@ -134,51 +374,120 @@ FA loadDfaFromFile(bool* faNullFlag) {
         return FA();
     }
 
-    pugi::xml_document file;
-    pugi::xml_parse_result result = file.load_file(file_path.c_str());
-
-    if (!result) {
-        std::cout << "\nError loading file.\n\n";
+    FA fa = FA();
+    try {
+        fa = loadFAFromJffFile(file_path);
+    } catch (const std::exception& e) {
+        std::cout << "\n" << e.what() << "\n\n";
         *faNullFlag = true;
         return FA();
     }
-    
-    std::cout << "File loaded successfully.\n";
 
-    std::cout << "Setting up FA...\n";
+    std::cout << "FA successfully setted up.\n\n";
+
+    *faNullFlag = false;
+    return fa;
+}
+
+/**
+ * @brief Loads a FA from a JFLAP file
+ * 
+ * @param file_path The file's path
+ * @return The FA loaded from the file
+ * @throws std::runtime_error If the file can not be read, is not a FA file or has more
+ * symbols than a FA can hold
+ */
+FA loadFAFromJffFile(const std::string& file_path) {
+    // The file is mapped copy-on-write and parsed in place, so the names of the states and the
+    // symbols point into it instead of being copied. Only elements and their text are parsed
+    MappedFile mapped_file;
+    if (!mapped_file.open(file_path, true, true)) {
+        throw std::runtime_error("Error loading file.");
+    }
+    pugi::xml_document file;
+    pugi::xml_parse_result result = file.load_buffer_inplace(mapped_file.writableData(), mapped_file.size(),
+        pugi::parse_minimal | pugi::parse_escapes | pugi::parse_embed_pcdata, pugi::encoding_utf8);
+
+    if (!result) {
+        throw std::runtime_error("Error loading file.");
+    }
 
     if (strcmp(file.child("structure").child_value("type"), "fa") != 0) {
-        std::cout << "\nFile is not a finite automaton file.\n\n";
-        *faNullFlag = true;
-        return FA();
+        throw std::runtime_error("File is not a finite automaton file.");
     }
 
     FA fa = FA();
     pugi::xml_node automaton = file.child("structure").child("automaton");
 
+    // Counting the states, so that the tables of the FA are allocated only once
+    size_t state_count = 0;
+    for (pugi::xml_node node = automaton.child("state"); node; node = node.next_sibling("state")) {
+        state_count++;
+    }
+    fa.reserveStates(state_count);
+
+    // IDs of the states and the symbols by their names in the file. JFLAP names the states with
+    // small numbers, which index numbered_ids directly; other names are hashed. An empty name is
+    // no state
+    std::vector<stateId> numbered_ids(state_count, NO_STATE);
+    std::unordered_map<std::string_view, stateId> state_ids;
+    std::unordered_map<std::string_view, symbolId> symbol_ids;
+    auto internState = [&fa, &numbered_ids, &state_ids](std::string_view name) {
+        if (name.empty()) {
+            return NO_STATE;
+        }
+        size_t number = 0;
+        bool numbered = name.length() <= 9 && (name[0] != '0' || name.length() == 1);
+        for (size_t i = 0; numbered && i < name.length(); i++) {
+            numbered = name[i] >= '0' && name[i] <= '9';
+            number = number * 10 + (name[i] - '0');
+        }
+        if (numbered && number < numbered_ids.size()) {
+            if (numbered_ids[number] == NO_STATE) {
+                numbered_ids[number] = fa.internState(std::string(name));
+            }
+            return numbered_ids[number];
+        }
+        auto it = state_ids.find(name);
+        if (it != state_ids.end()) {
+            return it->second;
+        }
+        stateId id = fa.internState(std::string(name));
+        state_ids[name] = id;
+        return id;
+    };
+
     // Setting up states
     for (pugi::xml_node node = automaton.child("state"); node; node = node.next_sibling("state")) {
-        std::string id = node.attribute("id").value();
-        fa.addState(id);
+        stateId id = internState(node.attribute("id").value());
+        if (id == NO_STATE) continue;
         if (node.child("initial")) {
-            fa.setInitialState(id);
+            fa.setInitialStateId(id);
         }
         if (node.child("final")) {
-            fa.addFinalState(id);
+            fa.setFinalStateId(id);
         }
     }
 
     // Setting up transitions
     for (pugi::xml_node node = automaton.child("transition"); node; node = node.next_sibling("transition")) {
-        std::string symbol = node.child_value("read");
-        symbol = treatStringChar(symbol);
-        fa.addSymbol(symbol);
-        fa.addTransition(node.child_value("from"), symbol, node.child_value("to"));
+        std::string_view read = node.child_value("read");
+        auto it = symbol_ids.find(read);
+        if (it == symbol_ids.end()) {
+            std::string symbol = treatStringChar(std::string(read));
+            try {
+                fa.addSymbol(symbol);
+            } catch (const std::length_error& e) {
+                throw std::runtime_error(e.what());
+            }
+            it = symbol_ids.emplace(read, fa.internSymbol(symbol)).first;
+        }
+        stateId from = internState(node.child_value("from"));
+        stateId to = internState(node.child_value("to"));
+        if (from == NO_STATE || to == NO_STATE) continue;
+        fa.addTransitionId(from, it->second, to);
     }
 
-    std::cout << "FA successfully setted up.\n\n";
-
-    *faNullFlag = false;
     return fa;
 }
 
@@ -292,7 +601,7 @@ std::string treatStringChar(std::string stringChar) {
  * 
  * @param fa The FA to be exported
  */
-void exportDfaToFile(FA fa) {
+void exportDfaToFile(const FA& fa) {
     std::cout << "File name to export: ";
     std::string file_name;
     std::cin >> file_name;
@@ -305,56 +614,60 @@ void exportDfaToFile(FA fa) {
         return;
     }
 
-    std::cout << "Loading skeleton file...\n";
+    std::cout << "Exporting FA...\n";
 
-    std::string skeleton_path = s_base_path + "Data/skeleton.jff";
-    if (!existsFile(skeleton_path)) {
-        std::cout << "\nSkeleton file not found. Please recreate it.\n\n";
+    try {
+        JffWriter writer = JffWriter(file_path);
+        writer.write(fa);
+    } catch (const std::exception& e) {
+        std::cout << "\n" << e.what() << "\n\n";
         return;
     }
-    pugi::xml_document skeleton;
-    pugi::xml_parse_result result = skeleton.load_file(skeleton_path.c_str());
-    if (!result) {
-        std::cout << "\nError loading skeleton file. Please recreate it.\n\n";
+
+    std::cout << "\nDFA successfully exported to " + file_path + ".\n\n";
+}
+
+/**
+ * @brief Exports a DFA to a C++ header that matches its language without loading any file
+ * 
+ * @param fa The DFA to be exported
+ */
+void exportDfaToHeader(const FA& fa) {
+    std::cout << "File name to export: ";
+    std::string file_name;
+    std::cin >> file_name;
+
+    std::string s_base_path = BASE_PATH;
+    std::string file_path = s_base_path + "Output/" + file_name;
+
+    if (existsFile(file_path)) {
+        std::cout << "\nFile already exists.\n\n";
         return;
     }
 
-    std::cout << "Exporting FA...\n";
-    
-    pugi::xml_node automaton = skeleton.child("structure").child("automaton");
+    std::cout << "Namespace of the generated code: ";
+    std::string name;
+    std::cin >> name;
 
-    // Setting up states
-    for (state s : fa.getStates()) {
-        pugi::xml_node state = automaton.append_child("state");
-        state.append_attribute("id") = s.c_str();
-        state.append_attribute("name") = ("q" + s).c_str();
-        state.append_child("x").append_child(pugi::node_pcdata).set_value("0");
-        state.append_child("y").append_child(pugi::node_pcdata).set_value("0");
-        if (s == fa.getInitialState()) {
-            state.append_child("initial");
-        }
-        if (fa.isFinalState(s)) {
-            state.append_child("final");
-        }
-    }
+    std::cout << "Code style (1. switch state machine, 2. constexpr table): ";
+    int style;
+    std::cin >> style;
 
-    // Setting up transitions
-    for (std::pair<const transition, std::set<state>> const& it : fa.getTransitions()) {
-        const pugi::char_t* state1 = it.first.first.c_str();
-        const pugi::char_t* symbol = it.first.second.c_str();
-        if (strcmp(symbol, "&") == 0) {
-            symbol = "";
-        }
-        for (state s : it.second) {
-            const pugi::char_t* state2 = s.c_str();
-            pugi::xml_node transition = automaton.append_child("transition");
-            transition.append_child("from").append_child(pugi::node_pcdata).set_value(state1);
-            transition.append_child("to").append_child(pugi::node_pcdata).set_value(state2);
-            transition.append_child("read").append_child(pugi::node_pcdata).set_value(symbol);
-        }
+    std::string header;
+    try {
+        header = generateDfaHeader(fa, name, style == 1 ? SWITCH_CODE : TABLE_CODE);
+    } catch (const std::exception& e) {
+        std::cout << "\n" << e.what() << "\n\n";
+        return;
     }
 
-    skeleton.save_file(file_path.c_str());
+    std::ofstream file(file_path);
+    if (!file) {
+        std::cout << "\nError creating file.\n\n";
+        return;
+    }
+    file << header;
+    file.close();
 
     std::cout << "\nDFA successfully exported to " + file_path + ".\n\n";
 }
@@ -370,7 +683,7 @@ FA loadFAFromRegularExpression(bool* faNullFlag, std::string regular_expression)
 
     FA fa = getFAFromRE(regular_expression);
 
-    if (fa.getStates().size() == 0) {
+    if (fa.getStateCount() == 0) {
         std::cout << "\nInvalid regular expression.\n\n";
         *faNullFlag = true;
         return FA();
@@ -439,7 +752,7 @@ FA transformNfaToDfa(FA fa) {
 }
 
 /**
- * @brief Runs an O(n^2) algorithm that minimizes a DFA
+ * @brief Runs Hopcroft's O(n log n) algorithm that minimizes a DFA
  * 
  * @param dfa The DFA to be minimized
  * 
@@ -450,11 +763,23 @@ FA minimizeDFA(FA dfa) {
         std::cout << "\nThe automaton is not deterministic.\n\n";
         return dfa;
     }
-    return automatonMinimizationAlgorithm(dfa);
+
+    FA newDfa = dfa;
+    try {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        newDfa = automatonMinimizationAlgorithm(dfa);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        std::cout << "Minimization time: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms\n\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+    }
+
+    return newDfa;
 }
 
 /**
- * @brief Generates a DFA with n states. The DFA forces the worst case to the O(n^2) algorithm.
+ * @brief Generates a DFA with n states. The DFA forces the worst case to the minimization
+ * algorithm, since no two states are equivalent.
  * 
  * @param n The number of states
  * @return The generated DFA
@@ -474,11 +799,22 @@ FA generateDfa(int n) {
 }
 
 /**
- * @brief Tests multiple sentences in a FA. The sentences are read from a file.
+ * @brief Tests multiple sentences in a FA. The sentences are read from a file and matched in
+ * parallel, and the results are printed in the order of the file.
  * 
  * @param fa The FA to be tested
  */
-void testMultipleSentences(FA fa) {
+void testMultipleSentences(const FA& fa) {
+    testMultipleSentences(Matcher(fa));
+}
+
+/**
+ * @brief Tests multiple sentences with a Matcher. The sentences are read from a file and
+ * matched in parallel, and the results are printed in the order of the file.
+ * 
+ * @param matcher The Matcher of the automaton to be tested
+ */
+void testMultipleSentences(const Matcher& matcher) {
     std::cout << "File name to load: ";
     std::string file_name;
     std::cin >> file_name;
@@ -493,20 +829,231 @@ void testMultipleSentences(FA fa) {
         return;
     }
 
-    std::ifstream file(file_path);
-    std::string line;
+    // The file is mapped in memory and the sentences are matched in place
+    MappedFile file;
+    if (!file.open(file_path)) {
+        std::cout << "\nError loading file.\n\n";
+        return;
+    }
+    std::vector<std::string_view> sentences = file.getLines();
 
-    if (file.is_open()) {
-        while (getline(file,line)) {
-            std::cout << "\nSentence: " << line << " => ";
-            if (fa.testSentence(line)) {
-                std::cout << "Accepted.";
-            } else {
-                std::cout << "Rejected.";
+    // The automaton is shared by all the workers
+    BufferedWriter writer(std::cout);
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    size_t accepted = testSentencesInParallel(matcher, sentences, writer);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    std::cout << "\n\nAccepted " << accepted << " of " << sentences.size() << " sentences (" << matcher.getEngineName() << ").";
+    std::cout << "\nLiteral prefilter: " << matcher.getPrefilter().getDescription() << ".";
+    std::cout << "\nMatching time: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms";
+    std::cout << "\n\n";
+}
+
+/**
+ * @brief Compiles a DFA and saves it to a binary file, which can be loaded with no parsing
+ * 
+ * @param fa The DFA to be saved
+ */
+void saveCompiledDfa(const FA& fa) {
+    if (!fa.isDeterministic()) {
+        std::cout << "\nThe FA is not deterministic. Please transform it first.\n\n";
+        return;
+    }
+
+    std::cout << "File name to export: ";
+    std::string file_name;
+    std::cin >> file_name;
+
+    std::string s_base_path = BASE_PATH;
+    std::string file_path = s_base_path + "Output/" + file_name;
+
+    if (existsFile(file_path)) {
+        std::cout << "\nFile already exists.\n\n";
+        return;
+    }
+
+    try {
+        CompiledDfa(fa).saveToFile(file_path);
+    } catch (const std::exception& e) {
+        std::cout << "\n" << e.what() << "\n\n";
+        return;
+    }
+
+    std::cout << "\nDFA successfully exported to " + file_path + ".\n\n";
+}
+
+/**
+ * @brief Loads a compiled DFA from a binary file and tests multiple sentences from a file
+ * against it
+ */
+void testSentencesWithCompiledDfa() {
+    std::cout << "Compiled DFA file name to load: ";
+    std::string file_name;
+    std::cin >> file_name;
+
+    std::string s_base_path = BASE_PATH;
+    std::string file_path = s_base_path + "Data/" + file_name;
+
+    if (!existsFile(file_path)) {
+        std::cout << "\nFile not found.\n\n";
+        return;
+    }
+
+    CompiledDfa dfa;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    try {
+        dfa = CompiledDfa::loadFromFile(file_path);
+    } catch (std::runtime_error& e) {
+        std::cout << "\n" << e.what() << "\n\n";
+        return;
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    std::cout << "Loaded " << dfa.getStateCount() << " states in " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "us.\n";
+    testMultipleSentences(Matcher(dfa));
+}
+
+/**
+ * @brief Compiles a RE into a minimized DFA, or loads it from the cache if it was compiled
+ * before, and tests multiple sentences from a file against it
+ */
+void testSentencesWithCachedRE() {
+    std::cout << "Regular Expression: ";
+    std::string regular_expression;
+    std::cin >> regular_expression;
+    regular_expression = treatExpression(regular_expression);
+
+    std::string s_base_path = BASE_PATH;
+    DfaCache cache = DfaCache(s_base_path + "Cache/");
+
+    CompiledDfa dfa;
+    bool hit = false;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    try {
+        dfa = cache.compile(regular_expression, true, &hit);
+    } catch (const std::exception& e) {
+        std::cout << "\n" << e.what() << "\n\n";
+        return;
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    std::cout << (hit ? "Loaded " : "Compiled ") << dfa.getStateCount() << " states in " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "us.\n";
+    testMultipleSentences(Matcher(dfa));
+}
+
+/**
+ * @brief Finds the leftmost-longest matches of a FA's language in a text file. The file is
+ * scanned by a Searcher instead of testing each substring, see Searcher for its cost.
+ * 
+ * @param fa The FA whose language is searched
+ */
+void searchTextFile(const FA& fa) {
+    std::cout << "File name to load: ";
+    std::string file_name;
+    std::cin >> file_name;
+
+    std::cout << "Loading file...\n";
+
+    std::string s_base_path = BASE_PATH;
+    std::string file_path = s_base_path + "Data/" + file_name;
+
+    if (!existsFile(file_path)) {
+        std::cout << "\nFile not found.\n\n";
+        return;
+    }
+
+    MappedFile file;
+    if (!file.open(file_path)) {
+        std::cout << "\nError loading file.\n\n";
+        return;
+    }
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    Searcher searcher(fa);
+    std::vector<matchSpan> matches = searcher.search(file.data(), file.size());
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    BufferedWriter writer(std::cout);
+    for (const matchSpan& match : matches) {
+        writer.write("\nMatch [" + std::to_string(match.start) + ", " + std::to_string(match.end) + "): " +
+            std::string(file.data() + match.start, match.end - match.start));
+    }
+    writer.flush();
+
+    std::cout << "\n\nFound " << matches.size() << " matches.";
+    std::cout << "\nSearch time: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms";
+    std::cout << "\n\n";
+}
+
+/**
+ * @brief Tests multiple sentences against multiple REs at once. The REs are read from a file,
+ * one per line, and combined into a single PatternSet, so each sentence is read only once to
+ * find all the REs that accept it. The REs are numbered from 1, in the order of the file.
+ */
+void testSentencesAgainstPatterns() {
+    std::cout << "RE list file name to load: ";
+    std::string patterns_file_name;
+    std::cin >> patterns_file_name;
+    std::cout << "Sentences file name to load: ";
+    std::string sentences_file_name;
+    std::cin >> sentences_file_name;
+
+    std::cout << "Loading files...\n";
+
+    std::string s_base_path = BASE_PATH;
+    std::string patterns_file_path = s_base_path + "Data/" + patterns_file_name;
+    std::string sentences_file_path = s_base_path + "Data/" + sentences_file_name;
+
+    if (!existsFile(patterns_file_path) || !existsFile(sentences_file_path)) {
+        std::cout << "\nFile not found.\n\n";
+        return;
+    }
+
+    MappedFile patterns_file;
+    MappedFile sentences_file;
+    if (!patterns_file.open(patterns_file_path) || !sentences_file.open(sentences_file_path)) {
+        std::cout << "\nError loading file.\n\n";
+        return;
+    }
+
+    std::vector<std::string> expressions;
+    for (std::string_view line : patterns_file.getLines()) {
+        std::string expression = treatExpression(std::string(line));
+        if (!expression.empty()) {
+            expressions.push_back(expression);
+        }
+    }
+
+    PatternSet patterns;
+    try {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        patterns = PatternSet(expressions);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        std::cout << "Combined " << patterns.getPatternCount() << " REs into " << patterns.getStateCount() << " states.\n";
+        std::cout << "Build time: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "ms\n";
+    } catch (const std::exception& e) {
+        std::cout << "\n" << e.what() << "\n\n";
+        return;
+    }
+
+    BufferedWriter writer(std::cout);
+    for (std::string_view sentence : sentences_file.getLines()) {
+        patternSpan matched = patterns.match(sentence.data(), sentence.size());
+        std::string output = "\nSentence: " + std::string(sentence) + " => ";
+        if (matched.empty()) {
+            output += "No RE.";
+        } else {
+            output += "REs {";
+            for (patternId pattern : matched) {
+                output += std::to_string(pattern + 1) + ",";
             }
+            output.back() = '}';
+            output += ".";
         }
-        file.close();
+        writer.write(output);
     }
+    writer.flush();
 
     std::cout << "\n\n";
-}
\ No newline at end of file
+}
@@ -0,0 +1,193 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief A read-only view of the contents of a file. On POSIX systems the file is memory-mapped,
+ * so it is read straight from the page cache without being copied and processes that map the
+ * same file share its pages; elsewhere, or if the mapping fails, it is read into a buffer.
+ * 
+ * The views returned by a MappedFile are valid while it is alive. A file opened as writable is
+ * mapped copy-on-write, so it can be modified in memory, as by in-place parsers, without the
+ * changes ever reaching the file.
+ */
+class MappedFile {
+private:
+    char* contents;
+    size_t length;
+    bool mapped;
+    std::string buffer;
+
+    /**
+     * @brief Unmaps the file, if it is mapped
+     */
+    void release() {
+#ifndef _WIN32
+        if (this->mapped) {
+            munmap((void*) this->contents, this->length);
+        }
+#endif
+        this->contents = nullptr;
+        this->length = 0;
+        this->mapped = false;
+        this->buffer.clear();
+    }
+
+public:
+    // Constructors
+    MappedFile() {
+        this->contents = nullptr;
+        this->length = 0;
+        this->mapped = false;
+        this->buffer = std::string();
+    }
+
+    /**
+     * @brief Maps a file into memory
+     * 
+     * @param file_path The file's path
+     * @param sequential If the file will be read from start to end, rather than at random
+     * @param writable If the contents can be modified in memory
+     * @throws std::runtime_error If the file can not be read
+     */
+    MappedFile(const std::string& file_path, bool sequential = true, bool writable = false) : MappedFile() {
+        if (!this->open(file_path, sequential, writable)) {
+            throw std::runtime_error("Could not open file " + file_path + ".");
+        }
+    }
+
+    ~MappedFile() {
+        this->release();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps a file into memory, releasing the file mapped before
+     * 
+     * @param file_path The file's path
+     * @param sequential If the file will be read from start to end, rather than at random
+     * @param writable If the contents can be modified in memory
+     * @return true if the file could be read. false otherwise
+     */
+    bool open(const std::string& file_path, bool sequential = true, bool writable = false) {
+        this->release();
+#ifndef _WIN32
+        int fd = ::open(file_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)) {
+            if (file_stat.st_size == 0) {
+                close(fd);
+                return true;
+            }
+            void* address = mmap(nullptr, file_stat.st_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                if (sequential) {
+                    madvise(address, file_stat.st_size, MADV_SEQUENTIAL);
+                }
+                madvise(address, file_stat.st_size, MADV_WILLNEED);
+                this->contents = (char*) address;
+                this->length = file_stat.st_size;
+                this->mapped = true;
+            }
+        }
+        close(fd);
+        if (this->mapped) {
+            return true;
+        }
+#endif
+        // Fallback: reading the whole file into the buffer
+        std::ifstream file(file_path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        this->buffer = contents.str();
+        this->contents = &this->buffer[0];
+        this->length = this->buffer.size();
+        return true;
+    }
+
+    // MappedFile Information
+    /**
+     * @brief Gets the contents of the file
+     * 
+     * @return The first character of the file
+     */
+    const char* data() const {
+        return this->contents;
+    }
+
+    /**
+     * @brief Gets the contents of the file to be modified in memory. Only for files opened as
+     * writable
+     * 
+     * @return The first character of the file
+     */
+    char* writableData() {
+        return this->contents;
+    }
+
+    /**
+     * @brief Gets the size of the file
+     * 
+     * @return The size of the file in bytes
+     */
+    size_t size() const {
+        return this->length;
+    }
+
+    /**
+     * @brief Checks if the file is memory-mapped or was read into a buffer
+     * 
+     * @return true if the file is memory-mapped. false otherwise
+     */
+    bool isMapped() const {
+        return this->mapped;
+    }
+
+    /**
+     * @brief Splits the file in newline-delimited records, without copying them. As with
+     * getline, a newline at the end of the file does not start an empty last record
+     * 
+     * @return The views of the records, in order
+     */
+    std::vector<std::string_view> getLines() const {
+        std::vector<std::string_view> lines;
+        const char* current = this->contents;
+        const char* end = this->contents + this->length;
+        while (current < end) {
+            const char* newline = (const char*) memchr(current, '\n', end - current);
+            if (newline == nullptr) {
+                lines.push_back(std::string_view(current, end - current));
+                break;
+            }
+            lines.push_back(std::string_view(current, newline - current));
+            current = newline + 1;
+        }
+        return lines;
+    }
+};
@@ -0,0 +1,229 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "fa.cpp"
+#include "algorithms.cpp"
+#include "compiledDfa.cpp"
+#include "lazyDfa.cpp"
+#include "bitParallelNfa.cpp"
+#include "prefilter.cpp"
+
+/**
+ * @brief The engines a Matcher can run a FA with
+ */
+enum matchEngine {
+    DFA_TABLE,
+    BIT_PARALLEL,
+    LAZY_DFA
+};
+
+/**
+ * @brief The matching front end. It keeps an immutable copy of a FA and picks the fastest
+ * engine that can run it:
+ * 
+ * - the transition table of a CompiledDfa, for deterministic automatons;
+ * - a BitParallelNfa over a single machine word, for NFAs whose homogeneous (Glushkov)
+ *   automaton has up to 64 states, which needs no determinization at all;
+ * - a LazyDfa otherwise, which determinizes only what the input visits.
+ * 
+ * Before any of them, a LiteralPrefilter rejects the sentences that lack a literal every
+ * sentence of the language has, without running the automaton. If the alphabet has
+ * multi-character symbols, sentences are split by a SymbolTokenizer and the engines read the
+ * IDs of the symbols instead of bytes.
+ * 
+ * A Matcher is never modified after it is built, so one instance can be shared by any number
+ * of threads. The cache of the LazyDfa is mutable, so each thread gets its own with
+ * getLazyDfa() and passes it to matches(); without one, NFAs are simulated over sets of states.
+ */
+class Matcher {
+private:
+    // Shared so the LazyDfas, which point to it, stay valid when the Matcher is copied
+    std::shared_ptr<const FA> fa;
+    matchEngine engine;
+    LiteralPrefilter prefilter;
+    SymbolTokenizer tokenizer;
+    CompiledDfa dfa;
+    BitParallelNfa<1> bit_nfa;
+    LazyDfa lazy_dfa;
+
+    /**
+     * @brief Tests if a sentence is accepted by the FA
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @param cache A LazyDfa owned by the calling thread. nullptr to simulate NFAs over sets of
+     * states
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool matches(const char* sentence, size_t length, LazyDfa* cache) const {
+        if (!this->prefilter.mayMatch(sentence, length)) {
+            return false;
+        }
+        if (this->tokenizer.hasMultiCharSymbols()) {
+            std::vector<symbolId> symbols;
+            if (!this->tokenizer.tokenize(sentence, length, symbols)) {
+                return false;
+            }
+            return this->matchesSymbols(symbols.data(), symbols.size(), cache);
+        }
+        switch (this->engine) {
+        case DFA_TABLE:
+            return this->dfa.matches(sentence, length);
+        case BIT_PARALLEL:
+            return this->bit_nfa.matches(sentence, length);
+        default:
+            if (cache != nullptr) {
+                return cache->matches(sentence, length);
+            }
+            return this->fa->matches(sentence, length, this->fa->getInitialStateId());
+        }
+    }
+
+    /**
+     * @brief Tests if a sentence, already split into symbols, is accepted by the FA
+     * 
+     * @param symbols The IDs of the symbols of the sentence
+     * @param length The number of symbols
+     * @param cache A LazyDfa owned by the calling thread. nullptr to simulate NFAs over sets of
+     * states
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool matchesSymbols(const symbolId* symbols, size_t length, LazyDfa* cache) const {
+        switch (this->engine) {
+        case DFA_TABLE:
+            return this->dfa.matchesSymbols(symbols, length);
+        case BIT_PARALLEL:
+            return this->bit_nfa.matchesSymbols(symbols, length);
+        default:
+            if (cache != nullptr) {
+                return cache->matchesSymbols(symbols, length);
+            }
+            return this->fa->matchesSymbols(symbols, length, this->fa->getInitialStateId());
+        }
+    }
+
+public:
+    // Constructors
+    Matcher() {
+        this->fa = std::make_shared<const FA>();
+        this->engine = LAZY_DFA;
+        this->prefilter = LiteralPrefilter();
+        this->tokenizer = SymbolTokenizer();
+        this->dfa = CompiledDfa();
+        this->bit_nfa = BitParallelNfa<1>();
+        this->lazy_dfa = LazyDfa();
+    }
+
+    /**
+     * @brief Prepares a FA for matching
+     * 
+     * @param fa The FA
+     */
+    Matcher(const FA& fa) : Matcher() {
+        this->fa = std::make_shared<const FA>(fa);
+        this->prefilter = LiteralPrefilter(fa);
+        this->tokenizer = fa.getTokenizer();
+        if (fa.isDeterministic()) {
+            this->engine = DFA_TABLE;
+            this->dfa = CompiledDfa(fa);
+            return;
+        }
+
+        FA homogeneous = homogenizeFA(fa, 64);
+        if (homogeneous.getStateCount() > 0) {
+            this->engine = BIT_PARALLEL;
+            this->bit_nfa = BitParallelNfa<1>(homogeneous);
+        } else {
+            this->engine = LAZY_DFA;
+            this->lazy_dfa = LazyDfa(*this->fa);
+        }
+    }
+
+    /**
+     * @brief Prepares a compiled DFA for matching, such as one loaded from a binary file. It
+     * has no FA, so there is no literal prefilter and only single-character symbols are read
+     * 
+     * @param dfa The compiled DFA
+     */
+    Matcher(const CompiledDfa& dfa) : Matcher() {
+        this->engine = DFA_TABLE;
+        this->dfa = dfa;
+    }
+
+    // Matcher Information
+    /**
+     * @brief Gets the name of the engine used by the Matcher
+     * 
+     * @return The engine's name
+     */
+    std::string getEngineName() const {
+        switch (this->engine) {
+        case DFA_TABLE:
+            return "DFA table";
+        case BIT_PARALLEL:
+            return "bit-parallel NFA";
+        default:
+            return "lazy DFA";
+        }
+    }
+
+    /**
+     * @brief Gets the literal prefilter of the Matcher
+     * 
+     * @return The prefilter
+     */
+    const LiteralPrefilter& getPrefilter() const {
+        return this->prefilter;
+    }
+
+    /**
+     * @brief Gets an empty LazyDfa cache for the FA, to be used by a single thread. It is only
+     * used if the engine is LAZY_DFA
+     * 
+     * @return The LazyDfa
+     */
+    LazyDfa getLazyDfa() const {
+        return this->lazy_dfa;
+    }
+
+    // Matching
+    /**
+     * @brief Tests if a sentence is accepted by the FA
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool matches(const char* sentence, size_t length) const {
+        return this->matches(sentence, length, nullptr);
+    }
+
+    /**
+     * @brief Tests if a sentence is accepted by the FA, with a LazyDfa for NFAs
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @param cache A LazyDfa got from getLazyDfa(), owned by the calling thread
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool matches(const char* sentence, size_t length, LazyDfa& cache) const {
+        return this->matches(sentence, length, &cache);
+    }
+
+    /**
+     * @brief Tests if a sentence is accepted by the FA
+     * 
+     * @param sentence The sentence to be tested
+     * @return true if the sentence is accepted. false otherwise
+     */
+    bool testSentence(const std::string& sentence) const {
+        return this->matches(sentence.data(), sentence.length());
+    }
+};
@@ -0,0 +1,101 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "fa.cpp"
+#include "algorithms.cpp"
+#include "compiledDfa.cpp"
+
+/**
+ * @brief A set of Regular Expressions matched all at once. The REs are combined into a single
+ * multi-pattern automaton, determinized and minimized without merging states of different
+ * patterns, and compiled to a table, so finding every RE that accepts a sentence costs one pass
+ * over the sentence instead of one per RE.
+ * 
+ * A PatternSet is never modified after it is built, so one instance can be shared by any number
+ * of threads.
+ */
+class PatternSet {
+private:
+    std::vector<std::string> expressions;
+    CompiledDfa dfa;
+
+public:
+    // Constructors
+    PatternSet() {
+        this->expressions = std::vector<std::string>();
+        this->dfa = CompiledDfa();
+    }
+
+    /**
+     * @brief Builds the automaton of a list of REs. The ID of each pattern is its position in
+     * the list
+     * 
+     * @param expressions The REs
+     * @throws std::invalid_argument If any of the REs is invalid
+     */
+    PatternSet(const std::vector<std::string>& expressions) : PatternSet() {
+        this->expressions = expressions;
+        if (expressions.empty()) {
+            return;
+        }
+        FA nfa = getFAFromREs(expressions);
+        this->dfa = CompiledDfa(automatonMinimizationAlgorithm(determinizeFA(nfa), false));
+    }
+
+    // PatternSet Information
+    /**
+     * @brief Gets the number of patterns
+     * 
+     * @return The number of patterns
+     */
+    size_t getPatternCount() const {
+        return this->expressions.size();
+    }
+
+    /**
+     * @brief Gets the RE of a pattern
+     * 
+     * @param pattern The pattern's ID
+     * @return The RE
+     */
+    const std::string& getExpression(patternId pattern) const {
+        return this->expressions[pattern];
+    }
+
+    /**
+     * @brief Gets the number of states of the combined automaton, its dead state included
+     * 
+     * @return The number of states
+     */
+    uint32_t getStateCount() const {
+        return this->dfa.getStateCount();
+    }
+
+    // Matching
+    /**
+     * @brief Finds all the patterns that accept a sentence
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @return The sorted IDs of the patterns that accept the sentence
+     */
+    patternSpan match(const char* sentence, size_t length) const {
+        return this->dfa.matchPatterns(sentence, length);
+    }
+
+    /**
+     * @brief Finds all the patterns that accept a sentence
+     * 
+     * @param sentence The sentence
+     * @return The sorted IDs of the patterns that accept the sentence
+     */
+    patternSpan match(const std::string& sentence) const {
+        return this->match(sentence.data(), sentence.length());
+    }
+};
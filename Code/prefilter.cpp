@@ -0,0 +1,422 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <cstring>
+#include "fa.cpp"
+#include "algorithms.cpp"
+#include "lambdaClosure.cpp"
+
+// Longest prefix or suffix extracted by a LiteralPrefilter
+const size_t MAX_LITERAL_LENGTH = 256;
+
+/**
+ * @brief Literals that every sentence of the language of a FA must have, computed from the
+ * graph of the FA: a required prefix, a required suffix, bytes that must occur somewhere and the
+ * minimum length. A sentence that lacks any of them can be rejected with memcmp/memchr without
+ * running the automaton at all.
+ * 
+ * Multi-character symbols count as their characters, since sentences are split into symbols
+ * (see SymbolTokenizer) and the symbols spell the sentence. Everything is computed on the NFA
+ * itself (λ-transitions allowed), without determinizing it.
+ * 
+ * A LiteralPrefilter is never modified after it is built, so one instance can be shared by any
+ * number of threads.
+ */
+class LiteralPrefilter {
+private:
+    std::string prefix;
+    std::string suffix;
+    std::string required_bytes;
+    size_t min_length;
+
+    /**
+     * @brief Checks if a symbol of a FA reads some input
+     * 
+     * @param fa The FA
+     * @param symbol The symbol's ID
+     * @return true if the symbol has at least one character. false otherwise
+     */
+    static bool isInputSymbol(const FA& fa, symbolId symbol) {
+        return symbol != LAMBDA && !fa.getSymbolName(symbol).empty();
+    }
+
+    /**
+     * @brief Finds the states of a FA that can reach a final state
+     * 
+     * @param fa The FA
+     * @return A mask indexed by state ID with the live states
+     */
+    static std::vector<bool> getLiveStates(const FA& fa) {
+        std::vector<stateList> predecessors(fa.getStateCount());
+        for (transitionId t : fa.getTransitionView()) {
+            if (t.read == LAMBDA || isInputSymbol(fa, t.read)) {
+                predecessors[t.to].push_back(t.from);
+            }
+        }
+        std::vector<bool> live(fa.getStateCount(), false);
+        stateList worklist;
+        for (stateId s = 0; s < fa.getStateCount(); s++) {
+            if (fa.isFinalStateId(s)) {
+                live[s] = true;
+                worklist.push_back(s);
+            }
+        }
+        while (!worklist.empty()) {
+            stateId s = worklist.back();
+            worklist.pop_back();
+            for (stateId p : predecessors[s]) {
+                if (!live[p]) {
+                    live[p] = true;
+                    worklist.push_back(p);
+                }
+            }
+        }
+        return live;
+    }
+
+    /**
+     * @brief Gets the longest prefix shared by all the sentences of the language of a FA. The
+     * sets of states the FA can be in are followed from the initial state while none of them is
+     * final and all of them can only read the same symbol
+     * 
+     * @param fa The FA
+     * @param reversed_symbols If the characters of each symbol are added in reverse order, for
+     * reversed FAs
+     * @return The required prefix
+     */
+    static std::string getRequiredPrefix(const FA& fa, bool reversed_symbols = false) {
+        std::string prefix = "";
+        if (fa.getInitialStateId() == NO_STATE) {
+            return prefix;
+        }
+
+        LambdaClosure closures = LambdaClosure(fa);
+        std::vector<bool> live = getLiveStates(fa);
+        std::vector<uint32_t> marks(fa.getStateCount(), 0);
+        uint32_t generation = 1;
+
+        stateSpan initial_closure = closures.getClosure(fa.getInitialStateId());
+        stateList current(initial_closure.begin(), initial_closure.end());
+        stateList next;
+        while (prefix.length() < MAX_LITERAL_LENGTH) {
+            symbolId forced_symbol = NO_SYMBOL;
+            for (stateId s : current) {
+                if (fa.isFinalStateId(s)) {
+                    return prefix;
+                }
+                for (symbolId a = 1; a < fa.getSymbolCount(); a++) {
+                    if (!isInputSymbol(fa, a)) continue;
+                    for (stateId t : fa.transiteId(s, a)) {
+                        if (!live[t]) continue;
+                        if (forced_symbol != NO_SYMBOL && forced_symbol != a) {
+                            return prefix;
+                        }
+                        forced_symbol = a;
+                    }
+                }
+            }
+            if (forced_symbol == NO_SYMBOL) {
+                return prefix;
+            }
+            std::string symbol_name = fa.getSymbolName(forced_symbol);
+            if (reversed_symbols) {
+                std::reverse(symbol_name.begin(), symbol_name.end());
+            }
+            prefix += symbol_name;
+
+            generation++;
+            next.clear();
+            for (stateId s : current) {
+                for (stateId t : fa.transiteId(s, forced_symbol)) {
+                    if (!live[t]) continue;
+                    for (stateId u : closures.getClosure(t)) {
+                        if (marks[u] != generation) {
+                            marks[u] = generation;
+                            next.push_back(u);
+                        }
+                    }
+                }
+            }
+            std::swap(current, next);
+        }
+        return prefix;
+    }
+
+    /**
+     * @brief Finds the bytes read on every path from the initial state of a FA to each of its
+     * states. It is a must-pass data flow problem solved in a single worklist pass: the set of
+     * a state is the intersection, over its incoming transitions, of the set of the origin
+     * with the characters of the symbol. Sets only shrink, so a state is queued again at most
+     * once per byte it loses
+     * 
+     * @param fa The FA
+     * @param must_read Where must_read[s] is written, as a 256-bit mask, for the states s
+     * reachable from the initial state
+     * @return A mask indexed by state ID with the states reachable from the initial state
+     */
+    static std::vector<bool> getMustReadBytes(const FA& fa, std::vector<std::array<uint64_t, 4>>& must_read) {
+        std::vector<std::array<uint64_t, 4>> symbol_bytes(fa.getSymbolCount(), std::array<uint64_t, 4>());
+        for (symbolId a = 1; a < fa.getSymbolCount(); a++) {
+            for (char c : fa.getSymbolName(a)) {
+                symbol_bytes[a][(unsigned char) c / 64] |= ((uint64_t) 1) << ((unsigned char) c % 64);
+            }
+        }
+
+        must_read.assign(fa.getStateCount(), std::array<uint64_t, 4>());
+        std::vector<bool> reached(fa.getStateCount(), false);
+        std::vector<bool> queued(fa.getStateCount(), false);
+        stateList worklist;
+        reached[fa.getInitialStateId()] = true;
+        queued[fa.getInitialStateId()] = true;
+        worklist.push_back(fa.getInitialStateId());
+        while (!worklist.empty()) {
+            stateId s = worklist.back();
+            worklist.pop_back();
+            queued[s] = false;
+            for (symbolId a = 0; a < fa.getSymbolCount(); a++) {
+                if (a != LAMBDA && !isInputSymbol(fa, a)) continue;
+                std::array<uint64_t, 4> bytes = must_read[s];
+                for (size_t w = 0; w < 4; w++) {
+                    bytes[w] |= symbol_bytes[a][w];
+                }
+                for (stateId t : fa.transiteId(s, a)) {
+                    bool changed = !reached[t];
+                    if (reached[t]) {
+                        for (size_t w = 0; w < 4; w++) {
+                            uint64_t word = must_read[t][w] & bytes[w];
+                            changed = changed || word != must_read[t][w];
+                            must_read[t][w] = word;
+                        }
+                    } else {
+                        reached[t] = true;
+                        must_read[t] = bytes;
+                    }
+                    if (changed && !queued[t]) {
+                        queued[t] = true;
+                        worklist.push_back(t);
+                    }
+                }
+            }
+        }
+        return reached;
+    }
+
+    /**
+     * @brief Gets the length of the shortest sentence of the language of a FA, with Dijkstra's
+     * algorithm where each transition costs the length of its symbol
+     * 
+     * @param fa The FA
+     * @return The minimum length. 0 if the language is empty
+     */
+    static size_t getMinimumLength(const FA& fa) {
+        typedef std::pair<size_t, stateId> queueEntry;
+        std::vector<size_t> distance(fa.getStateCount(), SIZE_MAX);
+        std::priority_queue<queueEntry, std::vector<queueEntry>, std::greater<queueEntry>> queue;
+        distance[fa.getInitialStateId()] = 0;
+        queue.push(std::make_pair(0, fa.getInitialStateId()));
+        while (!queue.empty()) {
+            queueEntry entry = queue.top();
+            queue.pop();
+            stateId s = entry.second;
+            if (entry.first > distance[s]) continue;
+            if (fa.isFinalStateId(s)) {
+                return distance[s];
+            }
+            for (symbolId a = 0; a < fa.getSymbolCount(); a++) {
+                if (a != LAMBDA && !isInputSymbol(fa, a)) continue;
+                size_t cost = a == LAMBDA ? 0 : fa.getSymbolName(a).length();
+                for (stateId t : fa.transiteId(s, a)) {
+                    if (distance[s] + cost < distance[t]) {
+                        distance[t] = distance[s] + cost;
+                        queue.push(std::make_pair(distance[t], t));
+                    }
+                }
+            }
+        }
+        return 0;
+    }
+
+public:
+    // Constructors
+    LiteralPrefilter() {
+        this->prefix = "";
+        this->suffix = "";
+        this->required_bytes = "";
+        this->min_length = 0;
+    }
+
+    /**
+     * @brief Extracts the literals of a FA
+     * 
+     * @param fa The FA. It may be non-deterministic and have λ-transitions
+     */
+    LiteralPrefilter(const FA& fa) : LiteralPrefilter() {
+        if (fa.getInitialStateId() == NO_STATE) {
+            return;
+        }
+
+        this->prefix = getRequiredPrefix(fa);
+        this->suffix = getRequiredPrefix(reverseFA(fa), true);
+        std::reverse(this->suffix.begin(), this->suffix.end());
+        this->min_length = getMinimumLength(fa);
+
+        // A byte is required if every path to every reachable final state reads it. With no
+        // reachable final state, every byte of the alphabet is
+        std::vector<std::array<uint64_t, 4>> must_read;
+        std::vector<bool> reached = getMustReadBytes(fa, must_read);
+        std::array<uint64_t, 4> required;
+        required.fill(UINT64_MAX);
+        for (stateId s = 0; s < fa.getStateCount(); s++) {
+            if (!reached[s] || !fa.isFinalStateId(s)) continue;
+            for (size_t w = 0; w < 4; w++) {
+                required[w] &= must_read[s][w];
+            }
+        }
+
+        // Bytes already checked by the prefix and the suffix are left out
+        std::vector<bool> seen(256, false);
+        for (symbolId a = 1; a < fa.getSymbolCount(); a++) {
+            if (!isInputSymbol(fa, a)) continue;
+            for (char c : fa.getSymbolName(a)) {
+                unsigned char byte = c;
+                if (seen[byte]) continue;
+                seen[byte] = true;
+                if (this->prefix.find(c) != std::string::npos || this->suffix.find(c) != std::string::npos) continue;
+                if ((required[byte / 64] >> (byte % 64)) & 1) {
+                    this->required_bytes += c;
+                }
+            }
+        }
+    }
+
+    // LiteralPrefilter Information
+    /**
+     * @brief Gets the prefix every sentence must start with
+     * 
+     * @return The prefix. Empty if there is none
+     */
+    const std::string& getPrefix() const {
+        return this->prefix;
+    }
+
+    /**
+     * @brief Gets the suffix every sentence must end with
+     * 
+     * @return The suffix. Empty if there is none
+     */
+    const std::string& getSuffix() const {
+        return this->suffix;
+    }
+
+    /**
+     * @brief Gets the bytes every sentence must contain, besides the ones of the prefix and
+     * the suffix
+     * 
+     * @return The bytes
+     */
+    const std::string& getRequiredBytes() const {
+        return this->required_bytes;
+    }
+
+    /**
+     * @brief Gets the length of the shortest sentence
+     * 
+     * @return The minimum length
+     */
+    size_t getMinimumLength() const {
+        return this->min_length;
+    }
+
+    /**
+     * @brief Checks if the prefilter can reject any sentence
+     * 
+     * @return true if there is no literal to check. false otherwise
+     */
+    bool isEmpty() const {
+        return this->min_length == 0;
+    }
+
+    /**
+     * @brief Describes the literals of the prefilter
+     * 
+     * @return The description
+     */
+    std::string getDescription() const {
+        if (this->isEmpty()) {
+            return "none";
+        }
+        std::string description = "minimum length " + std::to_string(this->min_length);
+        if (!this->prefix.empty()) {
+            description += ", prefix \"" + this->prefix + "\"";
+        }
+        if (!this->suffix.empty()) {
+            description += ", suffix \"" + this->suffix + "\"";
+        }
+        if (!this->required_bytes.empty()) {
+            description += ", required bytes \"" + this->required_bytes + "\"";
+        }
+        return description;
+    }
+
+    // Filtering
+    /**
+     * @brief Checks if a sentence has all the literals. Only sentences that pass can be
+     * accepted by the FA
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @return false if the sentence is surely rejected. true otherwise
+     */
+    bool mayMatch(const char* sentence, size_t length) const {
+        if (length < this->min_length) {
+            return false;
+        }
+        if (memcmp(sentence, this->prefix.data(), this->prefix.length()) != 0) {
+            return false;
+        }
+        if (memcmp(sentence + length - this->suffix.length(), this->suffix.data(), this->suffix.length()) != 0) {
+            return false;
+        }
+        for (char c : this->required_bytes) {
+            if (memchr(sentence, c, length) == nullptr) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checks if a text may contain a non-empty match of the FA, that is, if it contains
+     * the prefix, the suffix and the required bytes somewhere
+     * 
+     * @param text The first character of the text
+     * @param length The length of the text
+     * @return false if the text surely has no non-empty match. true otherwise
+     */
+    bool mayContainMatch(const char* text, size_t length) const {
+        if (length < this->min_length) {
+            return false;
+        }
+        std::string_view view(text, length);
+        if (view.find(this->prefix) == std::string_view::npos || view.find(this->suffix) == std::string_view::npos) {
+            return false;
+        }
+        for (char c : this->required_bytes) {
+            if (memchr(text, c, length) == nullptr) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
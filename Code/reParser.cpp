@@ -0,0 +1,132 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// Types of the tokens of a RE in postfix form
+const char RE_SYMBOL = 's';
+const char RE_EMPTY = 'e';
+const char RE_CONCAT = '.';
+const char RE_UNION = '+';
+const char RE_STAR = '*';
+
+/**
+ * @brief A token of a RE in postfix form. Symbols carry the character they read, & being λ
+ */
+struct reToken {
+    char type;
+    char symbol;
+};
+
+/**
+ * @brief Gets the precedence of a binary operator of a RE
+ * 
+ * @param op The operator
+ * @return The operator's precedence. Higher binds tighter
+ */
+constexpr int getOperatorPrecedence(char op) {
+    switch (op) {
+    case RE_CONCAT:
+        return 2;
+    case RE_UNION:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Pops the operators of a stack to the output while they bind at least as tight as a
+ * given precedence, stopping at a '('
+ * 
+ * @param operators The stack of operators
+ * @param postfix The output
+ * @param precedence The precedence
+ */
+inline void popOperators(std::vector<char>& operators, std::vector<reToken>& postfix, int precedence) {
+    while (!operators.empty() && operators.back() != '(' && getOperatorPrecedence(operators.back()) >= precedence) {
+        postfix.push_back({operators.back(), 0});
+        operators.pop_back();
+    }
+}
+
+/**
+ * @brief Parses a RE into postfix form with the shunting-yard algorithm, without recursion.
+ * Concatenation is implicit in the RE and explicit in the postfix form, + is the union and *
+ * is the Kleene star. An empty operand (as in "a+" or "()") becomes a RE_EMPTY token
+ * 
+ * @param re The RE
+ * @return The tokens of the RE in postfix form
+ * @throws std::invalid_argument If the RE is invalid
+ */
+inline std::vector<reToken> parseRegularExpression(const std::string& re) {
+    std::vector<reToken> postfix;
+    std::vector<char> operators;
+    postfix.reserve(2 * re.size() + 1);
+
+    // Whether the next token must start an operand
+    bool expecting_operand = true;
+
+    for (size_t i = 0; i < re.size(); i++) {
+        char c = re[i];
+        switch (c) {
+        case '(':
+            if (!expecting_operand) {
+                popOperators(operators, postfix, getOperatorPrecedence(RE_CONCAT));
+                operators.push_back(RE_CONCAT);
+            }
+            operators.push_back('(');
+            expecting_operand = true;
+            break;
+        case ')':
+            if (expecting_operand) {
+                postfix.push_back({RE_EMPTY, 0});
+            }
+            popOperators(operators, postfix, 0);
+            if (operators.empty()) {
+                throw std::invalid_argument("Unmatched ')'.");
+            }
+            operators.pop_back();
+            expecting_operand = false;
+            break;
+        case '+':
+            if (expecting_operand) {
+                postfix.push_back({RE_EMPTY, 0});
+            }
+            popOperators(operators, postfix, getOperatorPrecedence(RE_UNION));
+            operators.push_back(RE_UNION);
+            expecting_operand = true;
+            break;
+        case '*':
+            if (expecting_operand) {
+                throw std::invalid_argument("Kleene star without operand.");
+            }
+            postfix.push_back({RE_STAR, 0});
+            break;
+        default:
+            if (!expecting_operand) {
+                popOperators(operators, postfix, getOperatorPrecedence(RE_CONCAT));
+                operators.push_back(RE_CONCAT);
+            }
+            postfix.push_back({RE_SYMBOL, c});
+            expecting_operand = false;
+            break;
+        }
+    }
+
+    if (expecting_operand) {
+        postfix.push_back({RE_EMPTY, 0});
+    }
+    popOperators(operators, postfix, 0);
+    if (!operators.empty()) {
+        throw std::invalid_argument("Unmatched '('.");
+    }
+
+    return postfix;
+}
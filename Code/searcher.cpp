@@ -0,0 +1,175 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "fa.cpp"
+#include "algorithms.cpp"
+#include "compiledDfa.cpp"
+#include "prefilter.cpp"
+
+/**
+ * @brief How the matches of a search are reported
+ */
+enum searchMode {
+    // Non-overlapping matches, each one the longest that starts at the leftmost position left
+    LEFTMOST_LONGEST,
+    // Every span of the text that is a sentence of the language, overlapping ones included
+    ALL_MATCHES
+};
+
+/**
+ * @brief A match found in a text, as the half-open span [start, end)
+ */
+struct matchSpan {
+    size_t start;
+    size_t end;
+};
+
+/**
+ * @brief Finds the spans of a text that are sentences of the language of a FA, without
+ * testing every substring. Two DFAs are compiled:
+ * 
+ * - a backward DFA, for Σ*·reverse(L), which reads the text once from right to left and marks
+ *   every position where some match starts;
+ * - a forward DFA, for L, which is run only from the marked positions to find where their
+ *   matches end, stopping at its dead state.
+ * 
+ * Both DFAs are minimized, so the dead state is the only state that can not accept anymore and
+ * the forward scans stop as soon as no longer match is possible.
+ * 
+ * The backward scan is linear, and so is the search when the forward scans stop shortly after
+ * the longest match. It is not linear in the worst case: each forward scan may read up to the
+ * end of the text before reaching the dead state, as a+a*b does on aaaa..., so a search costs
+ * O(n·m), where n is the length of the text and m the longest scan. ALL_MATCHES also reports
+ * up to O(n²) spans.
+ * 
+ * Texts that lack the literals of the language (see LiteralPrefilter) are rejected before any
+ * scan. Since a text is not split into symbols, only the single-character symbols of the
+ * alphabet are searched.
+ * 
+ * A Searcher is never modified after it is built, so one instance can be shared by any number
+ * of threads.
+ */
+class Searcher {
+private:
+    CompiledDfa forward;
+    CompiledDfa backward;
+    LiteralPrefilter prefilter;
+
+    /**
+     * @brief Marks the positions of a text where some match starts, reading it backwards
+     * 
+     * @param text The first character of the text
+     * @param length The length of the text
+     * @return starts[i] is 1 if some match starts at i, for i in [0, length]
+     */
+    std::vector<uint8_t> findStarts(const char* text, size_t length) const {
+        const unsigned char* input = (const unsigned char*) text;
+        std::vector<uint8_t> starts(length + 1, 0);
+        uint32_t initial_state = this->backward.getInitialState();
+        uint32_t s = initial_state;
+        starts[length] = this->backward.isAccepting(s);
+        for (size_t i = length; i-- > 0;) {
+            s = this->backward.next(s, input[i]);
+            // Only a byte out of the alphabet kills Σ*·reverse(L). No match crosses it, so
+            // the scan starts over as if the text ended there
+            if (this->backward.isDead(s)) {
+                s = initial_state;
+            }
+            starts[i] = this->backward.isAccepting(s);
+        }
+        return starts;
+    }
+
+public:
+    // Constructors
+    Searcher() {
+        this->forward = CompiledDfa();
+        this->backward = CompiledDfa();
+        this->prefilter = LiteralPrefilter();
+    }
+
+    /**
+     * @brief Prepares the DFAs to search for the language of a FA
+     * 
+     * @param fa The FA. It may be non-deterministic and have λ-transitions
+     */
+    Searcher(const FA& fa) : Searcher() {
+        if (fa.getInitialStateId() == NO_STATE) {
+            return;
+        }
+        this->prefilter = LiteralPrefilter(fa);
+        this->forward = CompiledDfa(automatonMinimizationAlgorithm(determinizeFA(fa), false));
+        this->backward = CompiledDfa(automatonMinimizationAlgorithm(determinizeFA(reverseFA(fa, true)), false));
+    }
+
+    // Searching
+    /**
+     * @brief Finds the matches of the language in a text
+     * 
+     * @param text The first character of the text
+     * @param length The length of the text
+     * @param mode How the matches are reported
+     * @return The matches, sorted by start and then by end
+     */
+    std::vector<matchSpan> search(const char* text, size_t length, searchMode mode = LEFTMOST_LONGEST) const {
+        std::vector<matchSpan> matches;
+        if (!this->prefilter.mayContainMatch(text, length)) {
+            return matches;
+        }
+
+        const unsigned char* input = (const unsigned char*) text;
+        std::vector<uint8_t> starts = this->findStarts(text, length);
+
+        size_t i = 0;
+        while (i <= length) {
+            if (!starts[i]) {
+                i++;
+                continue;
+            }
+
+            uint32_t s = this->forward.getInitialState();
+            size_t longest = i;
+            if (mode == ALL_MATCHES && this->forward.isAccepting(s)) {
+                matches.push_back({i, i});
+            }
+            for (size_t j = i; j < length; j++) {
+                s = this->forward.next(s, input[j]);
+                if (this->forward.isDead(s)) break;
+                if (this->forward.isAccepting(s)) {
+                    longest = j + 1;
+                    if (mode == ALL_MATCHES) {
+                        matches.push_back({i, j + 1});
+                    }
+                }
+            }
+
+            if (mode == LEFTMOST_LONGEST) {
+                matches.push_back({i, longest});
+                // An empty match moves the search one position forward
+                i = longest > i ? longest : i + 1;
+            } else {
+                i++;
+            }
+        }
+
+        return matches;
+    }
+
+    /**
+     * @brief Finds the matches of the language in a text
+     * 
+     * @param text The text
+     * @param mode How the matches are reported
+     * @return The matches, sorted by start and then by end
+     */
+    std::vector<matchSpan> search(const std::string& text, searchMode mode = LEFTMOST_LONGEST) const {
+        return this->search(text.data(), text.length(), mode);
+    }
+};
@@ -0,0 +1,495 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <stdexcept>
+#include <type_traits>
+#include "reParser.cpp"
+
+// Default number of states a StaticRegex may reach before its DFA is minimized
+const size_t STATIC_DFA_MAX_STATES = 256;
+
+/**
+ * @brief A set of positions of a RE, as a fixed-size bitmask usable in constant expressions
+ */
+template <size_t WORDS>
+struct staticPositionSet {
+    std::array<uint64_t, WORDS> words;
+
+    constexpr staticPositionSet() : words() {}
+
+    constexpr void add(size_t p) {
+        this->words[p / 64] |= ((uint64_t) 1) << (p % 64);
+    }
+
+    constexpr bool has(size_t p) const {
+        return (this->words[p / 64] >> (p % 64)) & 1;
+    }
+
+    constexpr void unite(const staticPositionSet& other) {
+        for (size_t w = 0; w < WORDS; w++) {
+            this->words[w] |= other.words[w];
+        }
+    }
+
+    constexpr void intersect(const staticPositionSet& other) {
+        for (size_t w = 0; w < WORDS; w++) {
+            this->words[w] &= other.words[w];
+        }
+    }
+
+    constexpr bool empty() const {
+        for (size_t w = 0; w < WORDS; w++) {
+            if (this->words[w] != 0) return false;
+        }
+        return true;
+    }
+
+    constexpr bool operator==(const staticPositionSet& other) const {
+        for (size_t w = 0; w < WORDS; w++) {
+            if (this->words[w] != other.words[w]) return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief The position (Glushkov) NFA of a RE of up to LENGTH characters. Position 0 is the
+ * initial state and each symbol of the RE is a position, reached only by its byte
+ */
+template <size_t LENGTH>
+struct staticNfa {
+    static constexpr size_t POSITIONS = LENGTH + 1;
+    static constexpr size_t WORDS = (POSITIONS + 63) / 64;
+    typedef staticPositionSet<WORDS> positionSet;
+
+    size_t position_count;
+    std::array<unsigned char, POSITIONS> position_bytes;
+    // follow[p] is the set of positions that can come right after p
+    std::array<positionSet, POSITIONS> follow;
+    positionSet final_positions;
+
+    constexpr staticNfa() : position_count(1), position_bytes(), follow(), final_positions() {}
+};
+
+/**
+ * @brief A DFA built at compile time, before it is shrunk to its exact size. States are
+ * numbered from 0, the dead state, and table[s * (LENGTH + 1) + c] is the next state of s
+ * reading class c
+ */
+template <size_t LENGTH, size_t MAX_STATES>
+struct staticDfaScratch {
+    size_t state_count;
+    size_t class_count;
+    std::array<uint8_t, 256> byte_classes;
+    std::array<uint32_t, MAX_STATES * (LENGTH + 1)> table;
+    std::array<bool, MAX_STATES> accepting;
+    uint32_t initial_state;
+
+    constexpr staticDfaScratch() : state_count(0), class_count(0), byte_classes(), table(), accepting(), initial_state(0) {}
+};
+
+/**
+ * @brief Gets the length of a null-terminated string in a constant expression
+ * 
+ * @param re The string
+ * @return The length
+ */
+constexpr size_t getStaticLength(const char* re) {
+    size_t length = 0;
+    while (re[length] != '\0') {
+        length++;
+    }
+    return length;
+}
+
+/**
+ * @brief Builds the position NFA of a RE in a constant expression. The RE is parsed into
+ * postfix form with the same rules as parseRegularExpression, and the first, last and follow
+ * sets of the positions are computed while the postfix form is evaluated
+ * 
+ * @param re The RE, with LENGTH characters
+ * @return The position NFA
+ * @throws std::invalid_argument If the RE is invalid, which fails the compilation
+ */
+template <size_t LENGTH>
+constexpr staticNfa<LENGTH> buildStaticNfa(const char* re) {
+    typedef typename staticNfa<LENGTH>::positionSet positionSet;
+
+    if (re[0] == ')' || re[0] == '*' || re[0] == '+') {
+        throw std::invalid_argument("Invalid regular expression.");
+    }
+
+    // Shunting-yard, with fixed-size stacks
+    std::array<reToken, 2 * LENGTH + 1> postfix = {};
+    size_t postfix_size = 0;
+    std::array<char, 2 * LENGTH + 1> operators = {};
+    size_t operator_count = 0;
+    bool expecting_operand = true;
+    for (size_t i = 0; i <= LENGTH; i++) {
+        char c = i < LENGTH ? re[i] : ')';
+        int precedence = 0;
+        bool closing = c == ')';
+        if (c == '(' || (c != ')' && c != '+' && c != '*')) {
+            precedence = getOperatorPrecedence(RE_CONCAT);
+        } else if (c == '+') {
+            precedence = getOperatorPrecedence(RE_UNION);
+        }
+
+        if (c == '*') {
+            if (expecting_operand) {
+                throw std::invalid_argument("Kleene star without operand.");
+            }
+            postfix[postfix_size++] = {RE_STAR, 0};
+            continue;
+        }
+        if (closing || c == '+') {
+            if (expecting_operand) {
+                postfix[postfix_size++] = {RE_EMPTY, 0};
+            }
+        } else if (expecting_operand) {
+            // An operand starts, so there is no implicit concatenation
+            if (c == '(') {
+                operators[operator_count++] = '(';
+            } else {
+                postfix[postfix_size++] = {RE_SYMBOL, c};
+                expecting_operand = false;
+            }
+            continue;
+        }
+
+        while (operator_count > 0 && operators[operator_count - 1] != '(' && getOperatorPrecedence(operators[operator_count - 1]) >= precedence) {
+            postfix[postfix_size++] = {operators[--operator_count], 0};
+        }
+        if (closing) {
+            if (i == LENGTH) {
+                if (operator_count > 0) {
+                    throw std::invalid_argument("Unmatched '('.");
+                }
+                break;
+            }
+            if (operator_count == 0) {
+                throw std::invalid_argument("Unmatched ')'.");
+            }
+            operator_count--;
+            expecting_operand = false;
+        } else if (c == '+') {
+            operators[operator_count++] = RE_UNION;
+            expecting_operand = true;
+        } else {
+            // Implicit concatenation before a symbol or a '('
+            operators[operator_count++] = RE_CONCAT;
+            if (c == '(') {
+                operators[operator_count++] = '(';
+                expecting_operand = true;
+            } else {
+                postfix[postfix_size++] = {RE_SYMBOL, c};
+            }
+        }
+    }
+
+    // Evaluating the postfix form over fragments described by their first and last positions
+    struct fragment {
+        bool nullable;
+        positionSet first;
+        positionSet last;
+    };
+    staticNfa<LENGTH> nfa = staticNfa<LENGTH>();
+    std::array<fragment, 2 * LENGTH + 1> operands = {};
+    size_t operand_count = 0;
+    for (size_t i = 0; i < postfix_size; i++) {
+        reToken token = postfix[i];
+        if (token.type == RE_SYMBOL || token.type == RE_EMPTY) {
+            fragment operand = {true, positionSet(), positionSet()};
+            if (token.type == RE_SYMBOL && token.symbol != '&') {
+                size_t p = nfa.position_count++;
+                nfa.position_bytes[p] = (unsigned char) token.symbol;
+                operand.nullable = false;
+                operand.first.add(p);
+                operand.last.add(p);
+            }
+            operands[operand_count++] = operand;
+        } else if (token.type == RE_STAR) {
+            fragment& operand = operands[operand_count - 1];
+            for (size_t p = 1; p < nfa.position_count; p++) {
+                if (operand.last.has(p)) {
+                    nfa.follow[p].unite(operand.first);
+                }
+            }
+            operand.nullable = true;
+        } else {
+            fragment right = operands[--operand_count];
+            fragment& left = operands[operand_count - 1];
+            if (token.type == RE_CONCAT) {
+                for (size_t p = 1; p < nfa.position_count; p++) {
+                    if (left.last.has(p)) {
+                        nfa.follow[p].unite(right.first);
+                    }
+                }
+                if (left.nullable) {
+                    left.first.unite(right.first);
+                }
+                if (right.nullable) {
+                    right.last.unite(left.last);
+                }
+                left.last = right.last;
+                left.nullable = left.nullable && right.nullable;
+            } else {
+                left.first.unite(right.first);
+                left.last.unite(right.last);
+                left.nullable = left.nullable || right.nullable;
+            }
+        }
+    }
+
+    const fragment& root = operands[0];
+    nfa.follow[0] = root.first;
+    nfa.final_positions = root.last;
+    if (root.nullable) {
+        nfa.final_positions.add(0);
+    }
+    return nfa;
+}
+
+/**
+ * @brief Builds the minimal DFA of a RE in a constant expression: the position NFA is
+ * determinized with the subset construction, minimized with Moore's partition refinement, and
+ * bytes with identical columns are grouped in symbol classes as in CompiledDfa
+ * 
+ * @param re The RE, with LENGTH characters
+ * @return The minimal DFA, with the dead state as state 0
+ * @throws std::invalid_argument If the RE is invalid or the DFA has more than MAX_STATES
+ * states before minimization, which fails the compilation
+ */
+template <size_t LENGTH, size_t MAX_STATES>
+constexpr staticDfaScratch<LENGTH, MAX_STATES> buildStaticDfa(const char* re) {
+    typedef typename staticNfa<LENGTH>::positionSet positionSet;
+    const size_t STRIDE = LENGTH + 1;
+    staticNfa<LENGTH> nfa = buildStaticNfa<LENGTH>(re);
+
+    // A class for each distinct byte of the RE. Class 0 holds the bytes out of the alphabet
+    staticDfaScratch<LENGTH, MAX_STATES> dfa = staticDfaScratch<LENGTH, MAX_STATES>();
+    std::array<positionSet, STRIDE> class_positions = {};
+    size_t class_count = 1;
+    for (size_t p = 1; p < nfa.position_count; p++) {
+        uint8_t& byte_class = dfa.byte_classes[nfa.position_bytes[p]];
+        if (byte_class == 0) {
+            byte_class = class_count++;
+        }
+        class_positions[byte_class].add(p);
+    }
+
+    // Subset construction. State 0 is the empty set, the dead state
+    std::array<positionSet, MAX_STATES> subsets = {};
+    std::array<uint32_t, MAX_STATES * STRIDE> table = {};
+    size_t state_count = 2;
+    subsets[1].add(0);
+    for (size_t s = 1; s < state_count; s++) {
+        for (size_t c = 1; c < class_count; c++) {
+            positionSet next = positionSet();
+            for (size_t p = 0; p < nfa.position_count; p++) {
+                if (subsets[s].has(p)) {
+                    next.unite(nfa.follow[p]);
+                }
+            }
+            next.intersect(class_positions[c]);
+
+            size_t t = 0;
+            while (t < state_count && !(subsets[t] == next)) {
+                t++;
+            }
+            if (t == state_count) {
+                if (state_count == MAX_STATES) {
+                    throw std::invalid_argument("The DFA has too many states.");
+                }
+                subsets[state_count++] = next;
+            }
+            table[s * STRIDE + c] = t;
+        }
+    }
+
+    // Moore's algorithm. Blocks are numbered in order of their first state, so the dead state
+    // stays in block 0
+    std::array<uint32_t, MAX_STATES> blocks = {};
+    std::array<uint32_t, MAX_STATES> next_blocks = {};
+    std::array<uint32_t, MAX_STATES> representatives = {};
+    size_t block_count = 0;
+    for (size_t s = 0; s < state_count; s++) {
+        positionSet accepted = subsets[s];
+        accepted.intersect(nfa.final_positions);
+        dfa.accepting[s] = !accepted.empty();
+    }
+    for (size_t s = 0; s < state_count; s++) {
+        blocks[s] = dfa.accepting[s] == dfa.accepting[0] ? 0 : 1;
+    }
+    while (true) {
+        size_t next_block_count = 0;
+        for (size_t s = 0; s < state_count; s++) {
+            size_t b = 0;
+            for (; b < next_block_count; b++) {
+                size_t r = representatives[b];
+                bool same = blocks[r] == blocks[s];
+                for (size_t c = 1; same && c < class_count; c++) {
+                    same = blocks[table[r * STRIDE + c]] == blocks[table[s * STRIDE + c]];
+                }
+                if (same) break;
+            }
+            if (b == next_block_count) {
+                representatives[next_block_count++] = s;
+            }
+            next_blocks[s] = b;
+        }
+        blocks = next_blocks;
+        if (next_block_count == block_count) break;
+        block_count = next_block_count;
+    }
+
+    // Grouping the classes with identical columns
+    std::array<uint8_t, STRIDE> merged_classes = {};
+    size_t merged_count = 1;
+    for (size_t c = 1; c < class_count; c++) {
+        size_t m = 0;
+        for (; m < merged_count; m++) {
+            // The first class merged into m, 0 for the dead column
+            size_t d = 0;
+            while (d < c && merged_classes[d] != m) {
+                d++;
+            }
+            bool same = true;
+            for (size_t b = 0; same && b < block_count; b++) {
+                size_t r = representatives[b];
+                same = blocks[table[r * STRIDE + c]] == blocks[table[r * STRIDE + d]];
+            }
+            if (same) break;
+        }
+        if (m == merged_count) {
+            merged_count++;
+        }
+        merged_classes[c] = m;
+    }
+    for (size_t byte = 0; byte < 256; byte++) {
+        dfa.byte_classes[byte] = merged_classes[dfa.byte_classes[byte]];
+    }
+
+    // The minimal DFA has a state for each block
+    dfa.state_count = block_count;
+    dfa.class_count = merged_count;
+    for (size_t b = 0; b < block_count; b++) {
+        size_t r = representatives[b];
+        for (size_t c = 1; c < class_count; c++) {
+            dfa.table[b * STRIDE + merged_classes[c]] = blocks[table[r * STRIDE + c]];
+        }
+        dfa.accepting[b] = dfa.accepting[r];
+    }
+    dfa.initial_state = blocks[1];
+    return dfa;
+}
+
+/**
+ * @brief A minimal DFA of exactly STATES states and CLASSES symbol classes, laid out as in
+ * CompiledDfa: bytes are mapped to classes, state IDs are premultiplied by the number of classes
+ * and state 0 is a dead state. All of it can be read in constant expressions
+ */
+template <size_t STATES, size_t CLASSES>
+struct StaticDfa {
+    typedef typename std::conditional<STATES * CLASSES <= UINT16_MAX, uint16_t, uint32_t>::type stateIndex;
+
+    std::array<uint8_t, 256> byte_classes;
+    // table[s + c] is the next state of s reading class c
+    std::array<stateIndex, STATES * CLASSES> table;
+    std::array<bool, STATES> accepting;
+    stateIndex initial_state;
+
+    /**
+     * @brief Shrinks a DFA built at compile time to its exact size
+     * 
+     * @param scratch The DFA, with STATES states and CLASSES classes
+     */
+    template <size_t LENGTH, size_t MAX_STATES>
+    constexpr StaticDfa(const staticDfaScratch<LENGTH, MAX_STATES>& scratch) : byte_classes(scratch.byte_classes), table(), accepting(), initial_state(scratch.initial_state * CLASSES) {
+        for (size_t s = 0; s < STATES; s++) {
+            for (size_t c = 0; c < CLASSES; c++) {
+                this->table[s * CLASSES + c] = scratch.table[s * (LENGTH + 1) + c] * CLASSES;
+            }
+            this->accepting[s] = scratch.accepting[s];
+        }
+    }
+
+    /**
+     * @brief Tests if a sentence is accepted by the DFA
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @return true if the sentence is accepted. false otherwise
+     */
+    constexpr bool matches(const char* sentence, size_t length) const {
+        stateIndex s = this->initial_state;
+        for (size_t i = 0; i < length; i++) {
+            s = this->table[s + this->byte_classes[(unsigned char) sentence[i]]];
+        }
+        return this->accepting[s / CLASSES];
+    }
+};
+
+/**
+ * @brief A RE compiled into a minimal DFA during compilation, with no startup cost and no heap
+ * allocation. The pattern must be a constexpr character array with static storage:
+ * 
+ *     static constexpr char VALIDATOR[] = "(a+b)*abb";
+ *     static_assert(StaticRegex<VALIDATOR>::matches("aabb"));
+ * 
+ * The syntax is the same as getFAFromRE's. An invalid RE, or one whose DFA goes over MAX_STATES
+ * states before minimization, fails the compilation
+ */
+template <const char* PATTERN, size_t MAX_STATES = STATIC_DFA_MAX_STATES>
+class StaticRegex {
+private:
+    static constexpr size_t LENGTH = getStaticLength(PATTERN);
+    static constexpr staticDfaScratch<LENGTH, MAX_STATES> scratch = buildStaticDfa<LENGTH, MAX_STATES>(PATTERN);
+
+public:
+    static constexpr StaticDfa<scratch.state_count, scratch.class_count> dfa = StaticDfa<scratch.state_count, scratch.class_count>(scratch);
+
+    /**
+     * @brief Tests if a sentence is accepted by the RE
+     * 
+     * @param sentence The first character of the sentence
+     * @param length The length of the sentence
+     * @return true if the sentence is accepted. false otherwise
+     */
+    static constexpr bool matches(const char* sentence, size_t length) {
+        return dfa.matches(sentence, length);
+    }
+
+    /**
+     * @brief Tests if a sentence is accepted by the RE
+     * 
+     * @param sentence The sentence to be tested
+     * @return true if the sentence is accepted. false otherwise
+     */
+    static constexpr bool matches(std::string_view sentence) {
+        return dfa.matches(sentence.data(), sentence.size());
+    }
+};
+
+// Compiled uses of StaticRegex, so a change that breaks constant evaluation fails the build
+static constexpr char STATIC_DFA_CHECK_SUFFIX[] = "(a+b)*abb";
+static_assert(StaticRegex<STATIC_DFA_CHECK_SUFFIX>::matches("abb"));
+static_assert(StaticRegex<STATIC_DFA_CHECK_SUFFIX>::matches("babaabb"));
+static_assert(!StaticRegex<STATIC_DFA_CHECK_SUFFIX>::matches("abba"));
+static_assert(!StaticRegex<STATIC_DFA_CHECK_SUFFIX>::matches(""));
+static_assert(StaticRegex<STATIC_DFA_CHECK_SUFFIX>::dfa.accepting.size() == 5);
+
+static constexpr char STATIC_DFA_CHECK_STAR[] = "a*+bc";
+static_assert(StaticRegex<STATIC_DFA_CHECK_STAR>::matches(""));
+static_assert(StaticRegex<STATIC_DFA_CHECK_STAR>::matches("aaa"));
+static_assert(StaticRegex<STATIC_DFA_CHECK_STAR>::matches("bc"));
+static_assert(!StaticRegex<STATIC_DFA_CHECK_STAR>::matches("abc"));
+static_assert(!StaticRegex<STATIC_DFA_CHECK_STAR>::matches("d"));
@@ -0,0 +1,164 @@
+/**
+ * @author Bruno Pena Baêta (696997)
+ * @author Felipe Nepomuceno Coelho (689661)
+ */
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "fa.cpp"
+
+/**
+ * @brief Gets a 64-bit hash of a sorted set of states
+ * 
+ * @param states The first state of the set
+ * @param size The number of states of the set
+ * @return The hash of the set
+ */
+inline uint64_t hashSubset(const stateId* states, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL ^ size;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= states[i];
+        hash *= 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+// Marks an empty slot of the index of a SubsetTable
+const uint32_t SUBSET_EMPTY_SLOT = UINT32_MAX;
+
+/**
+ * @brief A table that interns sets of states (the super states of the subset construction) as
+ * dense IDs. The sets are stored sorted in a single pool and indexed by their 64-bit hash in a
+ * flat open-addressed table, so looking a set up costs one hash and, in case of a hit, one
+ * comparison, and the memory used by the table is known exactly.
+ */
+class SubsetTable {
+private:
+    // The states of subset i are pool[offsets[i]..offsets[i+1]]
+    std::vector<stateId> pool;
+    std::vector<size_t> offsets;
+    // hashes[i] is the hash of subset i
+    std::vector<uint64_t> hashes;
+    // Linearly probed slots with the IDs of the subsets, a power of two at most half full
+    std::vector<uint32_t> slots;
+
+    /**
+     * @brief Doubles the number of slots, placing the subsets again
+     */
+    void grow() {
+        std::vector<uint32_t> new_slots(this->slots.size() * 2, SUBSET_EMPTY_SLOT);
+        size_t mask = new_slots.size() - 1;
+        for (uint32_t id = 0; id < this->hashes.size(); id++) {
+            size_t slot = this->hashes[id] & mask;
+            while (new_slots[slot] != SUBSET_EMPTY_SLOT) {
+                slot = (slot + 1) & mask;
+            }
+            new_slots[slot] = id;
+        }
+        this->slots = new_slots;
+    }
+
+public:
+    // Constructors
+    SubsetTable() {
+        this->pool = std::vector<stateId>();
+        this->offsets = std::vector<size_t>(1, 0);
+        this->hashes = std::vector<uint64_t>();
+        this->slots = std::vector<uint32_t>(16, SUBSET_EMPTY_SLOT);
+    }
+
+    /**
+     * @brief Gets the ID of a subset, adding it to the table if it is not there yet
+     * 
+     * @param subset The subset. It must be sorted and without repetitions
+     * @param inserted Set to true if the subset was added to the table. false otherwise
+     * @return The ID of the subset
+     */
+    uint32_t intern(const stateList& subset, bool* inserted) {
+        uint64_t hash = hashSubset(subset.data(), subset.size());
+        size_t mask = this->slots.size() - 1;
+        size_t slot = hash & mask;
+        for (; this->slots[slot] != SUBSET_EMPTY_SLOT; slot = (slot + 1) & mask) {
+            uint32_t id = this->slots[slot];
+            if (this->hashes[id] == hash && this->getSize(id) == subset.size() &&
+                std::equal(subset.begin(), subset.end(), this->getStates(id))) {
+                *inserted = false;
+                return id;
+            }
+        }
+        uint32_t id = this->hashes.size();
+        this->pool.insert(this->pool.end(), subset.begin(), subset.end());
+        this->offsets.push_back(this->pool.size());
+        this->hashes.push_back(hash);
+        this->slots[slot] = id;
+        if (this->hashes.size() * 2 > this->slots.size()) {
+            this->grow();
+        }
+        *inserted = true;
+        return id;
+    }
+
+    /**
+     * @brief Gets the states of a subset
+     * 
+     * @param id The ID of the subset
+     * @return A pointer to the first state of the subset
+     */
+    const stateId* getStates(uint32_t id) const {
+        return this->pool.data() + this->offsets[id];
+    }
+
+    /**
+     * @brief Gets the number of states of a subset
+     * 
+     * @param id The ID of the subset
+     * @return The number of states of the subset
+     */
+    size_t getSize(uint32_t id) const {
+        return this->offsets[id + 1] - this->offsets[id];
+    }
+
+    /**
+     * @brief Gets the number of subsets in the table
+     * 
+     * @return The number of subsets
+     */
+    size_t size() const {
+        return this->offsets.size() - 1;
+    }
+
+    /**
+     * @brief Gets the number of states stored by all the subsets in the table
+     * 
+     * @return The number of states stored
+     */
+    size_t getPoolSize() const {
+        return this->pool.size();
+    }
+
+    /**
+     * @brief Gets the memory used by the subsets and their index
+     * 
+     * @return The number of bytes
+     */
+    size_t getMemoryUsage() const {
+        return this->pool.size() * sizeof(stateId) +
+            this->offsets.size() * sizeof(size_t) +
+            this->hashes.size() * sizeof(uint64_t) +
+            this->slots.size() * sizeof(uint32_t);
+    }
+
+    /**
+     * @brief Removes all the subsets from the table
+     */
+    void clear() {
+        this->pool.clear();
+        this->offsets.assign(1, 0);
+        this->hashes.clear();
+        this->slots = std::vector<uint32_t>(16, SUBSET_EMPTY_SLOT);
+    }
+};
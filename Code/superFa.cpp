@@ -3,6 +3,8 @@
  * @author Felipe Nepomuceno Coelho (689661)
  */
 
+#pragma once
+
 #include <set>
 #include <map>
 #include <utility>
@@ -52,11 +54,11 @@ public:
      * 
      * @param s The super state to be added
      */
-    void addState(superState s) {
+    void addState(const superState& s) {
         if (s.size() == 0) {
             return;
         }
-        if (has(this->getStates(),s)) {
+        if (has(this->states,s)) {
             return;
         }
         this->states.insert(s);
@@ -67,7 +69,7 @@ public:
      * 
      * @param symbol The symbol to be added
      */
-    void addSymbol(std::string symbol) {
+    void addSymbol(const std::string& symbol) {
         if (symbol.length() == 0) {
             return;
         }
@@ -90,7 +92,7 @@ public:
      * @param read The symbol that triggers the super transition
      * @param to The super state to which the transition goes
      */
-    void addTransition(superState from, std::string read, superState to) {
+    void addTransition(const superState& from, const std::string& read, const superState& to) {
         this->transitions[std::make_pair(from, read)] = to;
     }
 
@@ -99,7 +101,7 @@ public:
      * 
      * @param s The super state to be set as initial
      */
-    void setInitialState(superState s) {
+    void setInitialState(const superState& s) {
         this->initial_state = s;
     }
 
@@ -108,7 +110,7 @@ public:
      * 
      * @param s The super state to be added as final
      */
-    void addFinalState(superState s) {
+    void addFinalState(const superState& s) {
         this->final_states.insert(s);
     }
 
@@ -119,7 +121,7 @@ public:
      * @param s The super state to be checked
      * @return true if the super state is a final super state. false otherwise
      */
-    bool isFinalState(superState s) {
+    bool isFinalState(const superState& s) const {
         return this->final_states.find(s) != this->final_states.end();
     }
 
@@ -128,7 +130,7 @@ public:
      * 
      * @return The SuperFA's initial super state
      */
-    superState getInitialState() {
+    const superState& getInitialState() const {
         return this->initial_state;
     }
 
@@ -137,7 +139,7 @@ public:
      * 
      * @return The SuperFA's final states
      */
-    std::set<superState> getFinalStates() {
+    const std::set<superState>& getFinalStates() const {
         return this->final_states;
     }
 
@@ -146,9 +148,9 @@ public:
      * 
      * @return The SuperFA's non-final super states
      */
-    std::set<superState> getNonFinalStates() {
+    std::set<superState> getNonFinalStates() const {
         std::set<superState> non_final_states;
-        for (superState s : this->states) {
+        for (const superState& s : this->states) {
             if (!this->isFinalState(s)) {
                 non_final_states.insert(s);
             }
@@ -161,10 +163,16 @@ public:
      * 
      * @param from The super state from which the super transition starts
      * @param read The symbol that triggers the super transition
-     * @return The super state to which the super transition goes
+     * @return The super state to which the super transition goes. An empty super state if there
+     * is no such transition
      */
-    superState transite(superState from, std::string read) {
-        return this->transitions[std::make_pair(from, read)];
+    const superState& transite(const superState& from, const std::string& read) const {
+        static const superState no_state = superState();
+        auto it = this->transitions.find(std::make_pair(from, read));
+        if (it == this->transitions.end()) {
+            return no_state;
+        }
+        return it->second;
     }
 
     /**
@@ -172,7 +180,7 @@ public:
      * 
      * @return A set of super states that contains all the super states of the SuperFA
      */
-    std::set<superState> getStates() {
+    const std::set<superState>& getStates() const {
         return this->states;
     }
 
@@ -181,7 +189,7 @@ public:
      * 
      * @return A map that contains all the transitions of the SuperFA
      */
-    std::map<superTransition, superState> getTransitions() {
+    const std::map<superTransition, superState>& getTransitions() const {
         return this->transitions;
     }
 
@@ -190,7 +198,7 @@ public:
      * 
      * @return A set of strings that contains all the symbols of the SuperFA's alphabet
      */
-    std::set<std::string> getAlphabet() {
+    const std::set<std::string>& getAlphabet() const {
         return this->alphabet;
     }
 
@@ -198,11 +206,11 @@ public:
      * @brief Prints the SuperFA's states to the console
      * 
      */
-    void printStates() {
+    void printStates() const {
         std::string text = "States: {";
-        for (superState s : this->states) {
+        for (const superState& s : this->states) {
             text += "{";
-            for (state st : s) {
+            for (const state& st : s) {
                 text += (st + ",");
             }
             text.pop_back();
@@ -218,9 +226,9 @@ public:
      * 
      * @return true if the SuperFA is deterministic. false otherwise
      */
-    bool isDeterministic() {
-        for (superState s : this->states) {
-            for (std::string symbol : this->alphabet) {
+    bool isDeterministic() const {
+        for (const superState& s : this->states) {
+            for (const std::string& symbol : this->alphabet) {
                 if (this->transite(s, symbol).size() > 1) {
                     return false;
                 }
@@ -234,8 +242,8 @@ public:
      * 
      * @return true if the FA has lambda transitions. false otherwise
      */
-    bool hasLambda() {
-        for (superState s : this->states) {
+    bool hasLambda() const {
+        for (const superState& s : this->states) {
             if (this->transite(s, "").size() > 0) {
                 return true;
             }
@@ -248,19 +256,19 @@ public:
      * 
      * @return The FA that is equivalent to the SuperFA
      */
-    FA convertToFa() {
+    FA convertToFa() const {
         FA fa = FA();
         std::string separator = ",";
 
         // Setting up alphabet
-        for (std::string symbol : this->alphabet) {
+        for (const std::string& symbol : this->alphabet) {
             fa.addSymbol(symbol);
         }
 
         // Setting up states
-        for (superState ss : this->getStates()) {
+        for (const superState& ss : this->states) {
             std::string state_name = "";
-            for (state s : ss) {
+            for (const state& s : ss) {
                 state_name += (s + separator);
             }
             if (state_name == "") continue;
@@ -270,16 +278,16 @@ public:
 
         // Setting up initial state
         std::string initial_state_name = "";
-        for (state s : this->initial_state) {
+        for (const state& s : this->initial_state) {
             initial_state_name += (s + separator);
         }
         initial_state_name.pop_back();
         fa.setInitialState(initial_state_name);
 
         // Setting up final states
-        for (superState super_state : this->final_states) {
+        for (const superState& super_state : this->final_states) {
             std::string state_name = "";
-            for (state s : super_state) {
+            for (const state& s : super_state) {
                 state_name += (s + separator);
             }
             state_name.pop_back();
@@ -287,13 +295,13 @@ public:
         }
 
         // Setting up transitions
-        for (std::pair<superTransition, superState> p : this->transitions) {
+        for (const std::pair<const superTransition, superState>& p : this->transitions) {
             // Getting from state name
             if (p.first.first.size() == 0) {
                 continue;
             }
             std::string from_state_name = "";
-            for (state s : p.first.first) {
+            for (const state& s : p.first.first) {
                 from_state_name += (s + separator);
             }
             from_state_name.pop_back();
@@ -302,15 +310,14 @@ public:
             if (p.first.second.size() == 0) {
                 continue;
             }
-            std::string symbol = p.first.second;
+            const std::string& symbol = p.first.second;
 
             // Getting to state name
             if (p.second.size() == 0) {
                 continue;
             }
             std::string to_state_name = "";
-            superState to_super_state = p.second;
-            for (state s : to_super_state) {
+            for (const state& s : p.second) {
                 to_state_name += (s + separator);
             }
             to_state_name.pop_back();
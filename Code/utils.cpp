@@ -3,6 +3,8 @@
  * @author Felipe Nepomuceno Coelho (689661)
  */
 
+#pragma once
+
 #include <sys/stat.h>
 #include <string>
 #include <algorithm>
@@ -27,7 +29,7 @@ template <typename T>
  * @param element The element to be checked
  * @return true if the set contains the element. false otherwise
  */
-inline bool has(std::set<T> set, T element) {
+inline bool has(const std::set<T>& set, const T& element) {
     return set.find(element) != set.end();
 }
 
@@ -39,7 +41,7 @@ template <typename T>
  * @param set2 The second set
  * @return std::set<T> The difference between the two sets
  */
-inline std::set<T> getSetDifference(std::set<T> set1, std::set<T> set2) {
+inline std::set<T> getSetDifference(const std::set<T>& set1, const std::set<T>& set2) {
     std::set<T> difference;
     std::set_difference(set1.begin(), set1.end(), set2.begin(), set2.end(), std::inserter(difference, difference.begin()));
     return difference;
@@ -53,7 +55,7 @@ template <typename T>
  * @param set2 The second set
  * @return std::set<T> The union of the two sets
  */
-inline std::set<T> getSetUnion(std::set<T> set1, std::set<T> set2) {
+inline std::set<T> getSetUnion(const std::set<T>& set1, const std::set<T>& set2) {
     std::set<T> unionSet;
     std::set_union(set1.begin(), set1.end(), set2.begin(), set2.end(), std::inserter(unionSet, unionSet.begin()));
     return unionSet;
@@ -64,9 +66,9 @@ inline std::set<T> getSetUnion(std::set<T> set1, std::set<T> set2) {
  * 
  * @param ss The superState to be printed
  */
-inline void printSuperState(std::set<std::string> ss) {
+inline void printSuperState(const std::set<std::string>& ss) {
     std::string text = "{";
-    for (auto s : ss) {
+    for (const std::string& s : ss) {
         text += s + ", ";
     }
     text = text.substr(0, text.size() - 2);